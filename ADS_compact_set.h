@@ -0,0 +1,834 @@
+#ifndef ADS_COMPACT_SET_H
+#define ADS_COMPACT_SET_H
+
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * Integer set implemented with Linear hashing scheme and header-free buckets.
+ *
+ * Every bucket is a fixed page of N slots in one contiguous table. Unused
+ * slots hold the sentinel value Empty, which therefore cannot be stored.
+ * Values of a bucket are kept contiguous from its first slot, so the first
+ * Empty slot ends the bucket. Full buckets continue in a chain of overflow
+ * pages; the per-bucket chain pointers are only allocated once the first
+ * bucket overflows. Pages have a compile-time size, so whole-page compares
+ * against the probe key compile to vector instructions.
+ *
+ * @tparam Key integer key type
+ * @tparam Empty sentinel value marking unused slots
+ * @tparam N size of the buckets (b in lectures)
+ * @tparam Hash hash function object type
+ */
+template<typename Key, Key Empty, size_t N = 8, typename Hash = std::hash<Key>>
+class ADS_compact_set {
+    static_assert(std::is_integral_v<Key>, "Key must be an integer type");
+    static_assert(N > 0, "Buckets must hold at least one value");
+
+public:
+    class Iterator;
+
+    using value_type = Key;
+    using key_type = Key;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_iterator = Iterator;
+    using iterator = const_iterator;
+    using hasher = Hash;
+private:
+    /** Overflow page of a bucket */
+    struct Page {
+        value_type values[N];
+        Page* next;
+    };
+
+    /** Split round (d in lectures) */
+    size_type split_round {1};
+
+    /** Index of next bucket that should be split (nextToSplit in lectures) */
+    size_type table_split_index {0};
+
+    /** Number of allocated buckets */
+    size_type table_size {0};
+
+    /** Number of total values stored in buckets */
+    size_type table_items_size {0};
+
+    /** Number of performed bucket splits */
+    size_type table_split_count {0};
+
+    /** Slots of all buckets, N per bucket */
+    value_type* slots {nullptr};
+
+    /** First overflow page of every bucket; nullptr until a bucket overflows */
+    Page** overflow {nullptr};
+
+    /** Hash instance */
+    const hasher hash {};
+
+    /** Get the index of the bucket for a key */
+    size_type bucket_index(const key_type& key) const;
+
+    /** Get the slots of the bucket at the given index */
+    value_type* page_at(size_type index) const { return slots + index * N; }
+
+    /** Get the first overflow page of the bucket at the given index */
+    Page* overflow_at(size_type index) const { return overflow ? overflow[index] : nullptr; }
+
+    /**
+     * Find the position of a key in a page.
+     *
+     * @param page slots of the page
+     * @param key the key to find
+     * @return index of the key; N if it is not in the page
+     */
+    static size_type index_in_page(const value_type* page, const key_type& key);
+
+    /**
+     * Get the amount of used slots in a page.
+     *
+     * @param page slots of the page
+     * @return index of the first Empty slot; N if the page is full
+     */
+    static size_type page_size(const value_type* page);
+
+    /** Fill slots with the Empty sentinel */
+    static void clear_slots(value_type* first, size_type count);
+
+    /**
+     * Locate the slot storing the given key.
+     *
+     * @param key the key to locate
+     * @param bucket index of the bucket the key belongs to
+     * @param page set to the overflow page of the slot, nullptr for the bucket itself
+     * @return pointer to slot; nullptr if the key is not stored
+     */
+    value_type* locate(const key_type& key, size_type bucket, Page*& page) const;
+
+    /**
+     * Append a value to the end of a bucket, allocating an overflow page if needed.
+     *
+     * @return whether an overflow page was allocated
+     */
+    bool push(size_type bucket, value_type value);
+
+    /**
+     * Allocates the given amount of buckets for the hash table.
+     * This method will silently ignore smaller new table sizes.
+     *
+     * @param new_table_size
+     */
+    void reserve(size_type new_table_size);
+
+    /**
+     * Split the next bucket that should be split.
+     */
+    void split();
+
+    /**
+     * Free all overflow pages and tables.
+     */
+    void release();
+
+public:
+    /**
+     * Creates an empty set.
+     */
+    ADS_compact_set();
+
+    /**
+     * Delete the set.
+     */
+    ~ADS_compact_set();
+
+    /**
+     * Creates a set with a given range of items.
+     *
+     * @tparam InputIt type of input iterator
+     * @param first first item in range
+     * @param last last item in range
+     */
+    template<typename InputIt>
+    ADS_compact_set(InputIt first, InputIt last);
+
+    /**
+     * Creates a set with a given list of keys.
+     *
+     * @param ilist list of keys to initialize with
+     */
+    ADS_compact_set(std::initializer_list<key_type> ilist);
+
+    /**
+     * Creates a copy of a given set.
+     *
+     * @param other other set to copy from
+     */
+    ADS_compact_set(const ADS_compact_set& other);
+
+    /**
+     * Creates a set by moving values from other set.
+     *
+     * @param other other set to move from
+     */
+    ADS_compact_set(ADS_compact_set&& other) noexcept;
+
+    /**
+     * Copies the values of other set to this set by assignment operator.
+     *
+     * @param other other set to copy from
+     * @return reference to this set
+     */
+    ADS_compact_set& operator=(ADS_compact_set other);
+
+    /**
+     * Insert a given key.
+     *
+     * @param key the key to insert; must not be Empty
+     * @return iterator for value and boolean whether it was newly added
+     * @throws std::invalid_argument if key is Empty
+     */
+    std::pair<iterator, bool> insert(const key_type& key);
+
+    /**
+     * Insert a range of given keys.
+     *
+     * @tparam InputIt type of input iterator
+     * @param first first item in range
+     * @param last last item in range
+     */
+    template<typename InputIt>
+    void insert(InputIt first, InputIt last);
+
+    /**
+     * Clear all values of the set.
+     */
+    void clear();
+
+    /**
+     * Removes the given key from the hash table.
+     *
+     * @param key the key to remove
+     * @return the amount of removed elements
+     */
+    size_type erase(const key_type& key);
+
+    /**
+     * Count how many times a key exists in the set (0 or 1).
+     *
+     * @param key the key to count for
+     * @return how many times the key exists (0 or 1)
+     */
+    size_type count(const key_type& key) const;
+
+    /**
+     * Finds the given key's value in the hash table.
+     *
+     * @param key the key to find
+     * @return iterator of found value; if nothing was found the end iterator
+     */
+    iterator find(const key_type& key) const;
+
+    /**
+     * Swap this set with the given other set.
+     *
+     * @param other the set to swap with
+     */
+    void swap(ADS_compact_set& other);
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    [[nodiscard]] size_type size() const { return table_items_size; };
+
+    [[nodiscard]] bool empty() const { return table_items_size == 0; };
+
+    [[nodiscard]] size_type bucket_count() const { return (size_type {1} << split_round) + table_split_index; };
+
+    [[nodiscard]] size_type split_count() const { return table_split_count; };
+
+    /**
+     * Dump the set's content to a given stream.
+     *
+     * @param o the stream to dump to
+     */
+    void dump(std::ostream& o = std::cerr) const;
+
+    friend bool operator==(const ADS_compact_set& lhs, const ADS_compact_set& rhs) {
+        if (lhs.table_items_size != rhs.table_items_size) return false;
+
+        for (const auto& item: lhs) {
+            if (!rhs.count(item)) return false;
+        }
+
+        return true;
+    }
+
+    friend bool operator!=(const ADS_compact_set& lhs, const ADS_compact_set& rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+class ADS_compact_set<Key, Empty, N, Hash>::Iterator {
+public:
+    using value_type = Key;
+    using difference_type = std::ptrdiff_t;
+    using reference = const value_type&;
+    using pointer = const value_type*;
+    using iterator_category = std::forward_iterator_tag;
+private:
+    using set_pointer = const ADS_compact_set*;
+    using page_pointer = typename ADS_compact_set::Page*;
+    using set_size_type = typename ADS_compact_set::size_type;
+
+    /** Set to iterate */
+    set_pointer set {nullptr};
+
+    /** Index of current bucket */
+    set_size_type bucket {0};
+
+    /** Current overflow page, nullptr for the bucket's own slots */
+    page_pointer page {nullptr};
+
+    /** Index of current value in current page */
+    set_size_type index {0};
+
+    /** Get the slots of the current page */
+    const value_type* slots() const { return page ? page->values : set->page_at(bucket); }
+
+    /**
+     * Advance to the next used slot, starting at the current one.
+     */
+    void skip_empty_slots();
+
+public:
+    Iterator() = default;
+
+    explicit Iterator(set_pointer set, set_size_type bucket, page_pointer page, set_size_type index);
+
+    reference operator*() const { return slots()[index]; }
+
+    pointer operator->() const { return &(operator*()); }
+
+    Iterator& operator++();
+
+    Iterator operator++(int);
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+        return lhs.set == rhs.set && lhs.bucket == rhs.bucket && lhs.page == rhs.page && lhs.index == rhs.index;
+    }
+
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+typename ADS_compact_set<Key, Empty, N, Hash>::size_type
+ADS_compact_set<Key, Empty, N, Hash>::bucket_index(const key_type& key) const {
+    const size_type hash_value {hash(key)};
+    size_type index {hash_value & ((size_type {1} << split_round) - 1)};
+
+    // Use next split round's hash function for already split buckets
+    if (index < table_split_index) {
+        index = hash_value & ((size_type {2} << split_round) - 1);
+    }
+
+    return index;
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+typename ADS_compact_set<Key, Empty, N, Hash>::size_type
+ADS_compact_set<Key, Empty, N, Hash>::index_in_page(const value_type* page, const key_type& key) {
+    // Compare the whole page without early exit, which vectorizes
+    size_type found {N};
+
+    for (size_type i {N}; i-- > 0;) {
+        if (page[i] == key) found = i;
+    }
+
+    return found;
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+typename ADS_compact_set<Key, Empty, N, Hash>::size_type
+ADS_compact_set<Key, Empty, N, Hash>::page_size(const value_type* page) {
+    return index_in_page(page, Empty);
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+void ADS_compact_set<Key, Empty, N, Hash>::clear_slots(value_type* first, size_type count) {
+    if constexpr (Empty == 0) {
+        std::memset(first, 0, count * sizeof(value_type));
+    } else {
+        for (size_type i {0}; i < count; ++i) {
+            first[i] = Empty;
+        }
+    }
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+typename ADS_compact_set<Key, Empty, N, Hash>::value_type*
+ADS_compact_set<Key, Empty, N, Hash>::locate(const key_type& key, size_type bucket, Page*& page) const {
+    value_type* values {page_at(bucket)};
+    page = nullptr;
+
+    while (true) {
+        const size_type index {index_in_page(values, key)};
+
+        if (index != N) return values + index;
+
+        // A page with an Empty slot ends the bucket
+        if (values[N - 1] == Empty) return nullptr;
+
+        page = page ? page->next : overflow_at(bucket);
+
+        if (!page) return nullptr;
+
+        values = page->values;
+    }
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+bool ADS_compact_set<Key, Empty, N, Hash>::push(size_type bucket, value_type value) {
+    value_type* values {page_at(bucket)};
+    Page* page {nullptr};
+
+    // Walk to the last page of the bucket
+    while (values[N - 1] != Empty) {
+        Page* next {page ? page->next : overflow_at(bucket)};
+
+        if (!next) break;
+
+        page = next;
+        values = page->values;
+    }
+
+    const size_type index {page_size(values)};
+
+    if (index != N) {
+        values[index] = value;
+        return false;
+    }
+
+    // Allocate the chain pointers on first overflow
+    if (!overflow) {
+        overflow = static_cast<Page**>(std::calloc(table_size, sizeof(Page*)));
+
+        if (!overflow) throw std::bad_alloc {};
+    }
+
+    Page* fresh {static_cast<Page*>(std::malloc(sizeof(Page)))};
+
+    if (!fresh) throw std::bad_alloc {};
+
+    clear_slots(fresh->values, N);
+    fresh->values[0] = value;
+    fresh->next = nullptr;
+
+    if (page) page->next = fresh;
+    else overflow[bucket] = fresh;
+
+    return true;
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+void ADS_compact_set<Key, Empty, N, Hash>::reserve(size_type new_table_size) {
+    // Ignore calls that request making the table smaller
+    if (table_size >= new_table_size) return;
+
+    void* new_slots {std::realloc(slots, new_table_size * N * sizeof(value_type))};
+
+    if (!new_slots) throw std::bad_alloc {};
+
+    slots = static_cast<value_type*>(new_slots);
+    clear_slots(slots + table_size * N, (new_table_size - table_size) * N);
+
+    if (overflow) {
+        void* new_overflow {std::realloc(overflow, new_table_size * sizeof(Page*))};
+
+        if (!new_overflow) throw std::bad_alloc {};
+
+        overflow = static_cast<Page**>(new_overflow);
+        std::memset(overflow + table_size, 0, (new_table_size - table_size) * sizeof(Page*));
+    }
+
+    table_size = new_table_size;
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+void ADS_compact_set<Key, Empty, N, Hash>::split() {
+    // Calculate maximum table_size for this split round
+    const size_type max_table_size {size_type {1} << split_round};
+
+    // Double the table size if the new bucket does not fit
+    if (table_size <= max_table_size + table_split_index) {
+        reserve(max_table_size << 1);
+    }
+
+    const size_type source {table_split_index};
+    const size_type target {table_split_index + max_table_size};
+
+    // Compact the values that stay in place while reading the chain, writing never overtakes reading
+    value_type* read_values {page_at(source)};
+    value_type* write_values {read_values};
+    Page* read_page {nullptr};
+    Page* write_page {nullptr};
+    size_type write_index {0};
+
+    while (read_values) {
+        for (size_type i {0}; i < N && read_values[i] != Empty; ++i) {
+            const value_type value {read_values[i]};
+
+            if (hash(value) & max_table_size) {
+                push(target, value);
+                continue;
+            }
+
+            if (write_index == N) {
+                write_page = write_page ? write_page->next : overflow[source];
+                write_values = write_page->values;
+                write_index = 0;
+            }
+
+            write_values[write_index++] = value;
+        }
+
+        read_page = read_page ? read_page->next : overflow_at(source);
+        read_values = read_page ? read_page->values : nullptr;
+    }
+
+    // Clear the rest of the last written page and free the pages after it
+    clear_slots(write_values + write_index, N - write_index);
+
+    Page* unused {write_page ? write_page->next : overflow_at(source)};
+
+    if (write_page) write_page->next = nullptr;
+    else if (overflow) overflow[source] = nullptr;
+
+    while (unused) {
+        Page* next {unused->next};
+        std::free(unused);
+        unused = next;
+    }
+
+    ++table_split_count;
+
+    if (++table_split_index == max_table_size) {
+        // Advance split round if all buckets have been split
+        table_split_index = 0;
+        ++split_round;
+    }
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+void ADS_compact_set<Key, Empty, N, Hash>::release() {
+    if (overflow) {
+        for (size_type i {0}; i < table_size; ++i) {
+            Page* page {overflow[i]};
+
+            while (page) {
+                Page* next {page->next};
+                std::free(page);
+                page = next;
+            }
+        }
+    }
+
+    std::free(overflow);
+    std::free(slots);
+
+    overflow = nullptr;
+    slots = nullptr;
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+ADS_compact_set<Key, Empty, N, Hash>::ADS_compact_set() {
+    reserve(size_type {1} << split_round);
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+ADS_compact_set<Key, Empty, N, Hash>::~ADS_compact_set() {
+    release();
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+template<typename InputIt>
+ADS_compact_set<Key, Empty, N, Hash>::ADS_compact_set(InputIt first, InputIt last): ADS_compact_set {} {
+    insert(first, last);
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+ADS_compact_set<Key, Empty, N, Hash>::ADS_compact_set(std::initializer_list<key_type> ilist) :
+        ADS_compact_set {ilist.begin(), ilist.end()} {}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+ADS_compact_set<Key, Empty, N, Hash>::ADS_compact_set(const ADS_compact_set& other) : ADS_compact_set {} {
+    // Delegating makes the destructor free what was allocated if a later allocation throws
+    reserve(other.table_size);
+
+    split_round = other.split_round;
+    table_split_index = other.table_split_index;
+    table_items_size = other.table_items_size;
+    table_split_count = other.table_split_count;
+
+    // Buckets are plain slots, so the layout is copied as is
+    std::memcpy(slots, other.slots, table_size * N * sizeof(value_type));
+
+    if (other.overflow) {
+        overflow = static_cast<Page**>(std::calloc(table_size, sizeof(Page*)));
+
+        if (!overflow) throw std::bad_alloc {};
+
+        for (size_type i {0}; i < table_size; ++i) {
+            Page** link {&overflow[i]};
+
+            for (const Page* page {other.overflow[i]}; page; page = page->next) {
+                *link = static_cast<Page*>(std::malloc(sizeof(Page)));
+
+                if (!*link) throw std::bad_alloc {};
+
+                std::memcpy(*link, page, sizeof(Page));
+                (*link)->next = nullptr;
+                link = &(*link)->next;
+            }
+        }
+    }
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+ADS_compact_set<Key, Empty, N, Hash>::ADS_compact_set(ADS_compact_set&& other) noexcept: ADS_compact_set {} {
+    swap(other);
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+ADS_compact_set<Key, Empty, N, Hash>& ADS_compact_set<Key, Empty, N, Hash>::operator=(ADS_compact_set other) {
+    swap(other);
+
+    return *this;
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+std::pair<typename ADS_compact_set<Key, Empty, N, Hash>::iterator, bool>
+ADS_compact_set<Key, Empty, N, Hash>::insert(const key_type& key) {
+    if (key == Empty) throw std::invalid_argument {"the Empty sentinel cannot be inserted"};
+
+    size_type bucket {bucket_index(key)};
+    Page* page {nullptr};
+
+    if (value_type* slot {locate(key, bucket, page)}) {
+        return {Iterator {this, bucket, page, static_cast<size_type>(slot - (page ? page->values : page_at(bucket)))}, false};
+    }
+
+    // Split the next bucket if the key's bucket overflows
+    if (push(bucket, key)) {
+        split();
+        bucket = bucket_index(key);
+    }
+
+    ++table_items_size;
+
+    value_type* slot {locate(key, bucket, page)};
+
+    return {Iterator {this, bucket, page, static_cast<size_type>(slot - (page ? page->values : page_at(bucket)))}, true};
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+template<typename InputIt>
+void ADS_compact_set<Key, Empty, N, Hash>::insert(InputIt first, InputIt last) {
+    for (auto it {first}; it != last; ++it) {
+        insert(*it);
+    }
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+void ADS_compact_set<Key, Empty, N, Hash>::clear() {
+    // Clear all values by creating new empty set and swap them
+    ADS_compact_set tmp;
+    swap(tmp);
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+typename ADS_compact_set<Key, Empty, N, Hash>::size_type ADS_compact_set<Key, Empty, N, Hash>::erase(const key_type& key) {
+    if (key == Empty) return 0;
+
+    const size_type bucket {bucket_index(key)};
+    Page* page {nullptr};
+    value_type* slot {locate(key, bucket, page)};
+
+    if (!slot) return 0;
+
+    // Find the last value of the bucket and the page before the last page
+    Page* previous {nullptr};
+    Page* last {nullptr};
+    value_type* values {page_at(bucket)};
+
+    while (values[N - 1] != Empty) {
+        Page* next {last ? last->next : overflow_at(bucket)};
+
+        if (!next) break;
+
+        previous = last;
+        last = next;
+        values = last->values;
+    }
+
+    // Replace found value with the last value of the bucket
+    const size_type last_index {page_size(values) - 1};
+
+    *slot = values[last_index];
+    values[last_index] = Empty;
+
+    // Free an overflow page that became empty
+    if (last && last_index == 0) {
+        if (previous) previous->next = nullptr;
+        else overflow[bucket] = nullptr;
+
+        std::free(last);
+    }
+
+    --table_items_size;
+
+    return 1;
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+typename ADS_compact_set<Key, Empty, N, Hash>::size_type
+ADS_compact_set<Key, Empty, N, Hash>::count(const key_type& key) const {
+    if (key == Empty) return 0;
+
+    Page* page {nullptr};
+
+    return locate(key, bucket_index(key), page) != nullptr;
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+typename ADS_compact_set<Key, Empty, N, Hash>::iterator ADS_compact_set<Key, Empty, N, Hash>::find(const key_type& key) const {
+    if (key == Empty) return end();
+
+    const size_type bucket {bucket_index(key)};
+    Page* page {nullptr};
+    const value_type* slot {locate(key, bucket, page)};
+
+    if (!slot) return end();
+
+    return Iterator {this, bucket, page, static_cast<size_type>(slot - (page ? page->values : page_at(bucket)))};
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+void ADS_compact_set<Key, Empty, N, Hash>::swap(ADS_compact_set& other) {
+    using std::swap;
+
+    swap(split_round, other.split_round);
+    swap(table_split_index, other.table_split_index);
+    swap(table_size, other.table_size);
+    swap(table_items_size, other.table_items_size);
+    swap(table_split_count, other.table_split_count);
+    swap(slots, other.slots);
+    swap(overflow, other.overflow);
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+typename ADS_compact_set<Key, Empty, N, Hash>::const_iterator ADS_compact_set<Key, Empty, N, Hash>::begin() const {
+    return Iterator {this, 0, nullptr, 0};
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+typename ADS_compact_set<Key, Empty, N, Hash>::const_iterator ADS_compact_set<Key, Empty, N, Hash>::end() const {
+    return Iterator {this, table_size, nullptr, 0};
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+void ADS_compact_set<Key, Empty, N, Hash>::dump(std::ostream& o) const {
+    o << "split_round = " << split_round;
+    o << ", table_split_index = " << table_split_index;
+    o << ", table_size = " << table_size;
+    o << ", table_items_size = " << table_items_size;
+    o << "\n\n";
+
+    for (size_type i {0}; i < table_size; ++i) {
+        o << (table_split_index == i ? "-> " : "   ");
+        o << std::setfill(' ') << std::setw(4) << i << " | ";
+
+        const value_type* values {page_at(i)};
+
+        for (const Page* page {nullptr};;) {
+            for (size_type j {0}; j < N && values[j] != Empty; ++j) {
+                o << values[j] << " ";
+            }
+
+            page = page ? page->next : overflow_at(i);
+
+            if (!page) break;
+
+            values = page->values;
+            o << " -> | ";
+        }
+
+        o << "\n";
+    }
+
+    o << "\n";
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+void ADS_compact_set<Key, Empty, N, Hash>::Iterator::skip_empty_slots() {
+    while (bucket != set->table_size) {
+        if (index < N && slots()[index] != Empty) return;
+
+        // Continue in the overflow page, if the current page was full
+        page_pointer next {index == N ? (page ? page->next : set->overflow_at(bucket)) : nullptr};
+
+        if (next) {
+            page = next;
+        } else {
+            page = nullptr;
+            ++bucket;
+        }
+
+        index = 0;
+    }
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+ADS_compact_set<Key, Empty, N, Hash>::Iterator::Iterator(set_pointer set, set_size_type bucket, page_pointer page,
+                                                         set_size_type index) :
+        set {set}, bucket {bucket}, page {page}, index {index} {
+    skip_empty_slots();
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+typename ADS_compact_set<Key, Empty, N, Hash>::Iterator& ADS_compact_set<Key, Empty, N, Hash>::Iterator::operator++() {
+    // Do not advance when we reached the end bucket
+    if (bucket == set->table_size) {
+        return *this;
+    }
+
+    ++index;
+    skip_empty_slots();
+
+    return *this;
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+typename ADS_compact_set<Key, Empty, N, Hash>::Iterator ADS_compact_set<Key, Empty, N, Hash>::Iterator::operator++(int) {
+    Iterator tmp {*this};
+    ++*this;
+    return tmp;
+}
+
+template<typename Key, Key Empty, size_t N, typename Hash>
+void swap(ADS_compact_set<Key, Empty, N, Hash>& first, ADS_compact_set<Key, Empty, N, Hash>& second) {
+    first.swap(second);
+}
+
+#endif // ADS_COMPACT_SET_H
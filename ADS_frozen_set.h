@@ -0,0 +1,401 @@
+#ifndef ADS_FROZEN_SET_H
+#define ADS_FROZEN_SET_H
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include "ADS_hash.h"
+
+/**
+ * Immutable set with a minimal perfect hash, as returned by ADS_set::freeze().
+ *
+ * Keys are hashed into groups of about two keys. Each group stores a
+ * displacement, chosen at construction so all keys of all groups land in
+ * distinct slots (hash and displace). Groups of a single key are placed last
+ * and store their slot directly instead of searching for a displacement. The
+ * set has exactly one slot per key, so every lookup reads one displacement and
+ * probes exactly one slot.
+ *
+ * @tparam Key key type
+ * @tparam Hash hash function object type
+ */
+template<typename Key, typename Hash = std::hash<Key>>
+class ADS_frozen_set {
+public:
+    using value_type = Key;
+    using key_type = Key;
+    using reference = const value_type&;
+    using const_reference = const value_type&;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_iterator = const value_type*;
+    using iterator = const_iterator;
+    using key_equal = std::equal_to<key_type>;
+    using hasher = Hash;
+private:
+    /** Average amount of keys per group */
+    static constexpr size_type group_load {2};
+
+    /** Maximum amount of displacements tried for one group */
+    static constexpr std::uint32_t max_displacement {1u << 24};
+
+    /** Marks a displacement that holds the slot of a single key group */
+    static constexpr std::uint32_t direct_slot {1u << 31};
+
+    /** Number of stored values, which is also the number of slots */
+    size_type table_items_size {0};
+
+    /** Number of groups */
+    size_type group_count {0};
+
+    /** Slots of values */
+    value_type* values {nullptr};
+
+    /** Displacement of each group */
+    std::uint32_t* displacements {nullptr};
+
+    /** Hash instance */
+    const hasher hash {};
+
+    /** Get the group of a hash value */
+    size_type group_of(size_type hash_value) const {
+        return ADS_mix64(hash_value) % group_count;
+    }
+
+    /** Get the slot of a hash value for a group's displacement */
+    size_type slot_of(size_type hash_value, std::uint32_t displacement) const {
+        if (displacement & direct_slot) return displacement ^ direct_slot;
+
+        return ADS_mix64(hash_value + (displacement + std::uint64_t {1}) * 0x9e3779b97f4a7c15ULL) % table_items_size;
+    }
+
+    /**
+     * Place the given keys into slots.
+     *
+     * @param keys distinct keys to place
+     */
+    void build(const value_type* keys);
+
+public:
+    /**
+     * Creates an empty set.
+     */
+    ADS_frozen_set() = default;
+
+    /**
+     * Creates a set of a given range of distinct keys. The range is walked
+     * twice, to count and to copy the keys.
+     *
+     * @tparam ForwardIt type of forward iterator
+     * @param first first key in range
+     * @param last last key in range
+     * @throws std::invalid_argument if two distinct keys have the same hash value
+     * @throws std::length_error if the range holds 2^31 or more keys
+     */
+    template<typename ForwardIt>
+    ADS_frozen_set(ForwardIt first, ForwardIt last);
+
+    /**
+     * Creates a set of a given range of a known amount of distinct keys.
+     * The range is walked once, so input iterators suffice.
+     *
+     * @tparam InputIt type of input iterator
+     * @param first first key in range
+     * @param last last key in range
+     * @param size amount of keys in range
+     * @throws std::invalid_argument if two distinct keys have the same hash value
+     * @throws std::length_error if the range holds 2^31 or more keys
+     */
+    template<typename InputIt>
+    ADS_frozen_set(InputIt first, InputIt last, size_type size);
+
+    /**
+     * Delete the set.
+     */
+    ~ADS_frozen_set();
+
+    /**
+     * Creates a copy of a given set.
+     *
+     * @param other other set to copy from
+     */
+    ADS_frozen_set(const ADS_frozen_set& other);
+
+    /**
+     * Creates a set by moving values from other set.
+     *
+     * @param other other set to move from
+     */
+    ADS_frozen_set(ADS_frozen_set&& other) noexcept;
+
+    /**
+     * Copies the values of other set to this set by assignment operator.
+     *
+     * @param other other set to copy from
+     * @return reference to this set
+     */
+    ADS_frozen_set& operator=(ADS_frozen_set other);
+
+    /**
+     * Count how many times a key exists in the set (0 or 1).
+     *
+     * @param key the key to count for
+     * @return how many times the key exists (0 or 1)
+     */
+    size_type count(const key_type& key) const { return find(key) != end(); }
+
+    /**
+     * Finds the given key's value in the set.
+     *
+     * @param key the key to find
+     * @return iterator of found value; if nothing was found the end iterator
+     */
+    iterator find(const key_type& key) const;
+
+    /**
+     * Swap this set with the given other set.
+     *
+     * @param other the set to swap with
+     */
+    void swap(ADS_frozen_set& other);
+
+    const_iterator begin() const { return values; }
+
+    const_iterator end() const { return values + table_items_size; }
+
+    [[nodiscard]] size_type size() const { return table_items_size; };
+
+    [[nodiscard]] bool empty() const { return table_items_size == 0; };
+};
+
+template<typename Key, typename Hash>
+template<typename ForwardIt>
+ADS_frozen_set<Key, Hash>::ADS_frozen_set(ForwardIt first, ForwardIt last)
+    : ADS_frozen_set {first, last, static_cast<size_type>(std::distance(first, last))} {
+    static_assert(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<ForwardIt>::iterator_category>,
+                  "counting the keys walks the range a second time, pass their amount for input iterators");
+}
+
+template<typename Key, typename Hash>
+template<typename InputIt>
+ADS_frozen_set<Key, Hash>::ADS_frozen_set(InputIt first, InputIt last, size_type size) {
+    table_items_size = size;
+
+    if (table_items_size == 0) return;
+
+    value_type* keys {new value_type[table_items_size]};
+    size_type i {0};
+
+    try {
+        for (; first != last && i < table_items_size; ++first) keys[i++] = *first;
+
+        build(keys);
+    } catch (...) {
+        delete[] keys;
+        throw;
+    }
+
+    delete[] keys;
+}
+
+template<typename Key, typename Hash>
+void ADS_frozen_set<Key, Hash>::build(const value_type* keys) {
+    if (table_items_size >= direct_slot) throw std::length_error {"too many keys to freeze"};
+
+    group_count = (table_items_size + group_load - 1) / group_load;
+
+    size_type* hashes {new size_type[table_items_size]};
+    size_type* group_offsets {new size_type[group_count + 1] {}};
+    size_type* members {new size_type[table_items_size]};
+    size_type* order {new size_type[group_count]};
+    size_type* tried_slots {new size_type[table_items_size]};
+    bool* taken {new bool[table_items_size] {}};
+
+    auto release = [&]() {
+        delete[] hashes;
+        delete[] group_offsets;
+        delete[] members;
+        delete[] order;
+        delete[] tried_slots;
+        delete[] taken;
+    };
+
+    try {
+        values = new value_type[table_items_size];
+        displacements = new std::uint32_t[group_count] {};
+
+        // Collect the members of each group
+        for (size_type i {0}; i < table_items_size; ++i) {
+            hashes[i] = hash(keys[i]);
+            ++group_offsets[group_of(hashes[i]) + 1];
+        }
+
+        size_type largest_group {0};
+
+        for (size_type g {0}; g < group_count; ++g) {
+            if (group_offsets[g + 1] > largest_group) largest_group = group_offsets[g + 1];
+            group_offsets[g + 1] += group_offsets[g];
+        }
+
+        {
+            size_type* cursors {new size_type[group_count] {}};
+
+            for (size_type i {0}; i < table_items_size; ++i) {
+                const size_type g {group_of(hashes[i])};
+                members[group_offsets[g] + cursors[g]++] = i;
+            }
+
+            delete[] cursors;
+        }
+
+        // Order groups by descending size, placing large groups while most slots are free
+        size_type next {0};
+
+        for (size_type group_size {largest_group}; group_size > 1; --group_size) {
+            for (size_type g {0}; g < group_count; ++g) {
+                if (group_offsets[g + 1] - group_offsets[g] == group_size) order[next++] = g;
+            }
+        }
+
+        for (size_type o {0}; o < next; ++o) {
+            const size_type g {order[o]};
+            const size_type group_begin {group_offsets[g]};
+            const size_type group_end {group_offsets[g + 1]};
+
+            // Distinct keys of equal hash value would collide for every displacement
+            for (size_type i {group_begin}; i < group_end; ++i) {
+                for (size_type j {group_begin}; j < i; ++j) {
+                    if (hashes[members[i]] == hashes[members[j]]) {
+                        throw std::invalid_argument {"distinct keys with equal hash values cannot be frozen"};
+                    }
+                }
+            }
+
+            std::uint32_t displacement {0};
+
+            for (;; ++displacement) {
+                if (displacement == max_displacement) {
+                    throw std::runtime_error {"no perfect hash displacement found"};
+                }
+
+                size_type placed {0};
+
+                for (size_type i {group_begin}; i < group_end; ++i, ++placed) {
+                    const size_type slot {slot_of(hashes[members[i]], displacement)};
+
+                    if (taken[slot]) break;
+
+                    // Keys of the same group must not share a slot either
+                    taken[slot] = true;
+                    tried_slots[placed] = slot;
+                }
+
+                // Undo the partial placement of a failed try
+                if (group_begin + placed != group_end) {
+                    for (size_type p {0}; p < placed; ++p) taken[tried_slots[p]] = false;
+                    continue;
+                }
+
+                for (size_type p {0}; p < placed; ++p) {
+                    values[tried_slots[p]] = keys[members[group_begin + p]];
+                }
+
+                break;
+            }
+
+            displacements[g] = displacement;
+        }
+
+        // Fill the remaining slots with single key groups in order
+        size_type free_slot {0};
+
+        for (size_type g {0}; g < group_count; ++g) {
+            if (group_offsets[g + 1] - group_offsets[g] != 1) continue;
+
+            while (taken[free_slot]) ++free_slot;
+
+            taken[free_slot] = true;
+            values[free_slot] = keys[members[group_offsets[g]]];
+            displacements[g] = static_cast<std::uint32_t>(free_slot) | direct_slot;
+        }
+    } catch (...) {
+        release();
+        delete[] values;
+        delete[] displacements;
+        values = nullptr;
+        displacements = nullptr;
+        table_items_size = 0;
+        group_count = 0;
+        throw;
+    }
+
+    release();
+}
+
+template<typename Key, typename Hash>
+ADS_frozen_set<Key, Hash>::~ADS_frozen_set() {
+    delete[] values;
+    delete[] displacements;
+}
+
+template<typename Key, typename Hash>
+ADS_frozen_set<Key, Hash>::ADS_frozen_set(const ADS_frozen_set& other) :
+        table_items_size {other.table_items_size}, group_count {other.group_count} {
+    if (table_items_size == 0) return;
+
+    values = new value_type[table_items_size];
+
+    try {
+        displacements = new std::uint32_t[group_count];
+
+        for (size_type i {0}; i < table_items_size; ++i) values[i] = other.values[i];
+    } catch (...) {
+        delete[] values;
+        delete[] displacements;
+        throw;
+    }
+
+    for (size_type g {0}; g < group_count; ++g) displacements[g] = other.displacements[g];
+}
+
+template<typename Key, typename Hash>
+ADS_frozen_set<Key, Hash>::ADS_frozen_set(ADS_frozen_set&& other) noexcept {
+    swap(other);
+}
+
+template<typename Key, typename Hash>
+ADS_frozen_set<Key, Hash>& ADS_frozen_set<Key, Hash>::operator=(ADS_frozen_set other) {
+    swap(other);
+
+    return *this;
+}
+
+template<typename Key, typename Hash>
+typename ADS_frozen_set<Key, Hash>::iterator ADS_frozen_set<Key, Hash>::find(const key_type& key) const {
+    if (table_items_size == 0) return end();
+
+    const size_type hash_value {hash(key)};
+    const size_type slot {slot_of(hash_value, displacements[group_of(hash_value)])};
+
+    return key_equal {}(values[slot], key) ? values + slot : end();
+}
+
+template<typename Key, typename Hash>
+void ADS_frozen_set<Key, Hash>::swap(ADS_frozen_set& other) {
+    using std::swap;
+
+    swap(table_items_size, other.table_items_size);
+    swap(group_count, other.group_count);
+    swap(values, other.values);
+    swap(displacements, other.displacements);
+}
+
+template<typename Key, typename Hash>
+void swap(ADS_frozen_set<Key, Hash>& first, ADS_frozen_set<Key, Hash>& second) {
+    first.swap(second);
+}
+
+#endif // ADS_FROZEN_SET_H
@@ -0,0 +1,340 @@
+#ifndef ADS_HASH_H
+#define ADS_HASH_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+/**
+ * Finalizer of MurmurHash3 (fmix64), every input bit affects every output bit.
+ *
+ * @param x value to mix
+ * @return mixed value
+ */
+constexpr std::uint64_t ADS_mix64(std::uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+
+    return x;
+}
+
+/**
+ * Revert x ^= x >> shift on a value of the given width.
+ */
+constexpr std::uint64_t ADS_unxorshift(std::uint64_t x, unsigned shift, unsigned bits) {
+    std::uint64_t result {x};
+
+    for (unsigned i {shift}; i < bits; i += shift) {
+        result ^= x >> i;
+    }
+
+    return result;
+}
+
+/**
+ * Get the multiplicative inverse of an odd number modulo 2^64.
+ */
+constexpr std::uint64_t ADS_odd_inverse(std::uint64_t x) {
+    // Newton's iteration doubles the amount of correct low bits each step
+    std::uint64_t inverse {x};
+
+    for (int i {0}; i < 5; ++i) {
+        inverse *= 2 - x * inverse;
+    }
+
+    return inverse;
+}
+
+/**
+ * Finalizer of MurmurHash3 for 32 bit values (fmix32).
+ */
+constexpr std::uint32_t ADS_mix32(std::uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85ebca6bU;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35U;
+    x ^= x >> 16;
+
+    return x;
+}
+
+/**
+ * Inverse of ADS_mix32.
+ */
+constexpr std::uint32_t ADS_unmix32(std::uint32_t x) {
+    x = static_cast<std::uint32_t>(ADS_unxorshift(x, 16, 32));
+    x *= static_cast<std::uint32_t>(ADS_odd_inverse(0xc2b2ae35U));
+    x = static_cast<std::uint32_t>(ADS_unxorshift(x, 13, 32));
+    x *= static_cast<std::uint32_t>(ADS_odd_inverse(0x85ebca6bU));
+    x = static_cast<std::uint32_t>(ADS_unxorshift(x, 16, 32));
+
+    return x;
+}
+
+/**
+ * Inverse of ADS_mix64.
+ */
+constexpr std::uint64_t ADS_unmix64(std::uint64_t x) {
+    x = ADS_unxorshift(x, 33, 64);
+    x *= ADS_odd_inverse(0xc4ceb9fe1a85ec53ULL);
+    x = ADS_unxorshift(x, 33, 64);
+    x *= ADS_odd_inverse(0xff51afd7ed558ccdULL);
+    x = ADS_unxorshift(x, 33, 64);
+
+    return x;
+}
+
+/**
+ * Draw a seed for hashing that is hard to predict from outside the process.
+ *
+ * Seeds are consecutive values of a stream (splitmix64) that starts at a
+ * random_device value on first use, so drawing one costs an atomic addition.
+ *
+ * @return random seed
+ */
+inline std::uint64_t ADS_random_seed() {
+    static std::atomic<std::uint64_t> state {[] {
+        std::random_device device;
+
+        return (std::uint64_t {device()} << 32) ^ device();
+    }()};
+
+    return ADS_mix64(state.fetch_add(0x9e3779b97f4a7c15ULL, std::memory_order_relaxed));
+}
+
+/**
+ * Hash policy that mixes the result of another hash function.
+ *
+ * Linear hashing addresses buckets by the low bits of the hash only, so hash
+ * functions that leave low bits constant (like the identity std::hash for
+ * integers on aligned or shifted keys) pile values up in few buckets. Mixing
+ * spreads the entropy of all bits into the low ones.
+ *
+ * @tparam Key key type
+ * @tparam Base hash function object type to mix
+ */
+template<typename Key, typename Base = std::hash<Key>>
+struct ADS_mix_hash {
+    Base base {};
+
+    std::size_t operator()(const Key& key) const {
+        return static_cast<std::size_t>(ADS_mix64(static_cast<std::uint64_t>(base(key))));
+    }
+};
+
+/**
+ * Bijective hash policy for 32 and 64 bit integer keys.
+ *
+ * The hash value has the same width as the key and can be reverted by
+ * inverse(). ADS_set detects such policies and stores each key as its hash,
+ * so splits and comparisons never hash again while slots keep the key's size.
+ *
+ * @tparam Key integer key type
+ */
+template<typename Key>
+struct ADS_bijective_hash {
+    static_assert(std::is_integral_v<Key> && (sizeof(Key) == sizeof(std::uint32_t) || sizeof(Key) == sizeof(std::uint64_t)),
+                  "Key must be a 32 or 64 bit integer");
+
+    using unsigned_type = std::make_unsigned_t<Key>;
+
+    /** Marks the hash as reversible for ADS_set */
+    static constexpr bool bijective {true};
+
+    static constexpr unsigned_type mix(unsigned_type x) {
+        if constexpr (sizeof(Key) == sizeof(std::uint32_t)) {
+            return static_cast<unsigned_type>(ADS_mix32(x));
+        } else {
+            return static_cast<unsigned_type>(ADS_mix64(x));
+        }
+    }
+
+    static constexpr unsigned_type unmix(unsigned_type x) {
+        if constexpr (sizeof(Key) == sizeof(std::uint32_t)) {
+            return static_cast<unsigned_type>(ADS_unmix32(x));
+        } else {
+            return static_cast<unsigned_type>(ADS_unmix64(x));
+        }
+    }
+
+    constexpr std::size_t operator()(const Key& key) const {
+        return static_cast<std::size_t>(mix(static_cast<unsigned_type>(key)));
+    }
+
+    /**
+     * Get the key of a hash value.
+     *
+     * @param hash hash value computed by this policy
+     * @return the hashed key
+     */
+    static constexpr Key inverse(std::size_t hash) {
+        return static_cast<Key>(unmix(static_cast<unsigned_type>(hash)));
+    }
+};
+
+/**
+ * Hash policy usable in constant expressions, for integer and string_view keys.
+ *
+ * @tparam Key key type
+ */
+template<typename Key, typename = void>
+struct ADS_constexpr_hash;
+
+template<typename Key>
+struct ADS_constexpr_hash<Key, std::enable_if_t<std::is_integral_v<Key>>> {
+    constexpr std::size_t operator()(const Key& key) const {
+        return static_cast<std::size_t>(ADS_mix64(static_cast<std::uint64_t>(key)));
+    }
+};
+
+template<>
+struct ADS_constexpr_hash<std::string_view> {
+    constexpr std::size_t operator()(std::string_view key) const {
+        // FNV-1a, mixed as its low bits are weak
+        std::uint64_t hash {0xcbf29ce484222325ULL};
+
+        for (const char c: key) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+        }
+
+        return static_cast<std::size_t>(ADS_mix64(hash));
+    }
+};
+
+/**
+ * Read 8 bytes at any alignment.
+ */
+inline std::uint64_t ADS_load64(const char* data) {
+    std::uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+
+    return word;
+}
+
+/**
+ * Read the last word of a byte string, zero padded if it is shorter than 8
+ * bytes. Longer strings read the last 8 bytes, overlapping the words before.
+ */
+inline std::uint64_t ADS_load_tail64(const char* data, std::size_t size) {
+    if (size >= 8) return ADS_load64(data + size - 8);
+
+    std::uint64_t word {0};
+    std::memcpy(&word, data, size);
+
+    return word;
+}
+
+constexpr std::uint64_t ADS_rotl64(std::uint64_t x, unsigned bits) {
+    return (x << bits) | (x >> (64 - bits));
+}
+
+/**
+ * Portable hash of a byte string that reads 16 bytes per step in two
+ * independent multiply-rotate lanes.
+ *
+ * @param data first byte
+ * @param size amount of bytes
+ * @return hash value
+ */
+inline std::uint64_t ADS_hash_bytes_wide(const char* data, std::size_t size) {
+    constexpr std::uint64_t k1 {0x9e3779b97f4a7c15ULL};
+    constexpr std::uint64_t k2 {0xc2b2ae3d27d4eb4fULL};
+    std::uint64_t a {size * k1};
+    std::uint64_t b {~size * k2};
+    std::size_t i {0};
+
+    for (; i + 16 < size; i += 16) {
+        a = ADS_rotl64(a ^ (ADS_load64(data + i) * k2), 31) * k1;
+        b = ADS_rotl64(b ^ (ADS_load64(data + i + 8) * k1), 29) * k2;
+    }
+
+    if (i + 8 < size) a = ADS_rotl64(a ^ (ADS_load64(data + i) * k2), 31) * k1;
+
+    b = ADS_rotl64(b ^ (ADS_load_tail64(data, size) * k1), 29) * k2;
+
+    return ADS_mix64(a ^ ADS_rotl64(b, 32));
+}
+
+#if defined(__x86_64__)
+/**
+ * Hash of a byte string by CRC32C instructions (SSE4.2) in two lanes of 8
+ * bytes, combined to 64 bits and mixed. The last word is fed as two 32 bit
+ * halves, one per lane, so strings of equal length up to 8 bytes map to
+ * distinct values before the final mix. Requires a CPU with SSE4.2.
+ *
+ * @param data first byte
+ * @param size amount of bytes
+ * @return hash value
+ */
+__attribute__((target("sse4.2"))) inline std::uint64_t ADS_hash_bytes_crc32c(const char* data, std::size_t size) {
+    std::uint64_t a {0};
+    std::uint64_t b {0x9e3779b9U};
+    std::size_t i {0};
+
+    for (; i + 16 < size; i += 16) {
+        a = _mm_crc32_u64(a, ADS_load64(data + i));
+        b = _mm_crc32_u64(b, ADS_load64(data + i + 8));
+    }
+
+    if (i + 8 < size) a = _mm_crc32_u64(a, ADS_load64(data + i));
+
+    const std::uint64_t tail {ADS_load_tail64(data, size)};
+
+    a = _mm_crc32_u32(static_cast<std::uint32_t>(a), static_cast<std::uint32_t>(tail));
+    b = _mm_crc32_u32(static_cast<std::uint32_t>(b), static_cast<std::uint32_t>(tail >> 32));
+
+    return ADS_mix64(((a << 32) | b) + size * 0x9e3779b97f4a7c15ULL);
+}
+#endif
+
+/**
+ * Hash policy for std::string and std::string_view keys.
+ *
+ * Uses CRC32C instructions if the CPU supports SSE4.2, checked once at
+ * runtime, and ADS_hash_bytes_wide otherwise. Hash values therefore differ between
+ * machines and must not be stored or shared between processes. CRC32C is
+ * linear, so keys can be crafted to collide; do not use it for keys chosen
+ * by an adversary.
+ */
+struct ADS_string_hash {
+#if defined(__x86_64__)
+    /** Whether the CPU supports CRC32C instructions, checked once on first use */
+    static bool has_crc32c() {
+        static const bool supported {__builtin_cpu_supports("sse4.2") != 0};
+
+        return supported;
+    }
+#endif
+
+    std::size_t operator()(std::string_view key) const {
+#if defined(__x86_64__)
+        if (has_crc32c()) {
+            return static_cast<std::size_t>(ADS_hash_bytes_crc32c(key.data(), key.size()));
+        }
+#endif
+
+        return static_cast<std::size_t>(ADS_hash_bytes_wide(key.data(), key.size()));
+    }
+};
+
+/**
+ * Whether a hash policy declares itself bijective and provides inverse().
+ */
+template<typename Hash, typename = void>
+struct ADS_is_bijective_hash : std::false_type {};
+
+template<typename Hash>
+struct ADS_is_bijective_hash<Hash, std::void_t<decltype(Hash::bijective)>> : std::bool_constant<Hash::bijective> {};
+
+#endif // ADS_HASH_H
@@ -0,0 +1,218 @@
+#ifndef ADS_HASH_ANALYZER_H
+#define ADS_HASH_ANALYZER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "ADS_hash.h"
+#include "ADS_set.h"
+
+/**
+ * Result of analyzing a hash function on a sample of keys.
+ */
+struct ADS_hash_report {
+    /** Amount of distinct keys in the sample */
+    std::size_t keys {0};
+
+    /** Amount of distinct hash values of the sample */
+    std::size_t distinct_hashes {0};
+
+    /** Share of keys with bit i of the hash set */
+    std::vector<double> bit_bias;
+
+    /** Entropy in bits of the lowest b hash bits, at index b - 1 */
+    std::vector<double> low_bit_entropy;
+
+    /** Amount of buckets addressed by the linear hashing table */
+    std::size_t buckets {0};
+
+    /** Amount of buckets with k values, at index k */
+    std::vector<double> actual_bucket_sizes;
+
+    /** Amount of buckets with k values expected for a uniform hash, at index k */
+    std::vector<double> expected_bucket_sizes;
+
+    /** Total variation distance of both bucket size distributions (0 to 1) */
+    double distance {0};
+
+    /** Whether a mixing hash policy should be used */
+    bool recommend_mixing {false};
+
+    /**
+     * Print the report to a given stream.
+     *
+     * @param o the stream to print to
+     */
+    void print(std::ostream& o = std::cout) const;
+};
+
+/** Minimum share of the ideal low-bit entropy before mixing is recommended */
+constexpr double ADS_hash_min_entropy_ratio {0.9};
+
+/** Maximum distance from the expected bucket sizes before mixing is recommended */
+constexpr double ADS_hash_max_distance {0.1};
+
+/**
+ * Analyze how well the hash function suits linear hashing on a sample of keys.
+ *
+ * The keys are inserted into an ADS_set with the given parameters, whose
+ * split state determines the expected bucket size distribution: buckets that
+ * were split in the current round hold half the load of the unsplit ones,
+ * and each bucket's size is Poisson distributed for a uniform hash.
+ *
+ * @tparam Key key type
+ * @tparam N size of the buckets
+ * @tparam Hash hash function object type to analyze
+ * @tparam InputIt type of input iterator
+ * @param first first key of the sample
+ * @param last last key of the sample
+ * @return the analysis report
+ */
+template<typename Key, size_t N = 5, typename Hash = std::hash<Key>, typename InputIt>
+ADS_hash_report ADS_analyze_hash(InputIt first, InputIt last) {
+    constexpr std::size_t max_bits {16};
+    constexpr std::size_t hash_bits {8 * sizeof(std::size_t)};
+
+    const ADS_set<Key, N, Hash> set(first, last);
+    const Hash hash {};
+    ADS_hash_report report;
+
+    report.keys = set.size();
+    report.bit_bias.assign(hash_bits, 0);
+
+    if (report.keys == 0) return report;
+
+    // Only estimate the entropy of bit counts that the sample can cover
+    std::size_t bits {1};
+    while (bits < max_bits && (std::size_t {8} << bits) <= report.keys) ++bits;
+
+    std::vector<std::size_t> low_bits(std::size_t {1} << bits);
+    std::vector<std::size_t> hashes;
+    hashes.reserve(report.keys);
+
+    for (const auto& key: set) {
+        const std::size_t value {hash(key)};
+
+        hashes.push_back(value);
+        ++low_bits[value & (low_bits.size() - 1)];
+
+        for (std::size_t i {0}; i < hash_bits; ++i) {
+            report.bit_bias[i] += static_cast<double>((value >> i) & 1);
+        }
+    }
+
+    for (auto& bias: report.bit_bias) bias /= static_cast<double>(report.keys);
+
+    std::sort(hashes.begin(), hashes.end());
+    report.distinct_hashes = static_cast<std::size_t>(std::unique(hashes.begin(), hashes.end()) - hashes.begin());
+
+    // Fold the counts of the lowest bits down one bit at a time
+    report.low_bit_entropy.assign(bits, 0);
+
+    for (std::size_t b {bits}; b > 0; --b) {
+        const std::size_t width {std::size_t {1} << b};
+        double entropy {0};
+
+        for (std::size_t i {0}; i < width; ++i) {
+            if (low_bits[i] == 0) continue;
+
+            const double p {static_cast<double>(low_bits[i]) / static_cast<double>(report.keys)};
+            entropy -= p * std::log2(p);
+        }
+
+        report.low_bit_entropy[b - 1] = entropy;
+
+        for (std::size_t i {0}; i < width / 2; ++i) {
+            low_bits[i] += low_bits[i + width / 2];
+        }
+    }
+
+    // Actual bucket sizes
+    report.buckets = set.bucket_count();
+
+    for (std::size_t i {0}; i < report.buckets; ++i) {
+        const std::size_t size {set.bucket_size(i)};
+
+        if (size >= report.actual_bucket_sizes.size()) report.actual_bucket_sizes.resize(size + 1, 0);
+
+        report.actual_bucket_sizes[size] += 1;
+    }
+
+    // Expected bucket sizes for split (half load) and unsplit (full load) buckets
+    std::size_t round {0};
+    while ((std::size_t {2} << round) <= report.buckets) ++round;
+
+    const std::size_t unsplit {(std::size_t {2} << round) - report.buckets};
+    const std::size_t split {report.buckets - unsplit};
+    const double full_load {static_cast<double>(report.keys) / static_cast<double>(std::size_t {1} << round)};
+    const double half_load {full_load / 2};
+
+    const std::size_t max_size {std::max<std::size_t>(report.actual_bucket_sizes.size(),
+                                                      static_cast<std::size_t>(full_load * 4) + 8)};
+    report.actual_bucket_sizes.resize(max_size, 0);
+    report.expected_bucket_sizes.assign(max_size, 0);
+
+    for (std::size_t k {0}; k < max_size; ++k) {
+        const auto poisson = [k](double lambda) {
+            return std::exp(static_cast<double>(k) * std::log(lambda) - lambda - std::lgamma(static_cast<double>(k) + 1));
+        };
+
+        report.expected_bucket_sizes[k] = static_cast<double>(split) * poisson(half_load) +
+                                          static_cast<double>(unsplit) * poisson(full_load);
+        report.distance += std::abs(report.actual_bucket_sizes[k] - report.expected_bucket_sizes[k]);
+    }
+
+    report.distance /= 2 * static_cast<double>(report.buckets);
+
+    for (std::size_t b {1}; b <= bits; ++b) {
+        if (report.low_bit_entropy[b - 1] < ADS_hash_min_entropy_ratio * static_cast<double>(b)) {
+            report.recommend_mixing = true;
+        }
+    }
+
+    if (report.distance > ADS_hash_max_distance) report.recommend_mixing = true;
+
+    return report;
+}
+
+inline void ADS_hash_report::print(std::ostream& o) const {
+    o << std::fixed << std::setprecision(3);
+    o << "keys = " << keys << ", distinct hashes = " << distinct_hashes << ", buckets = " << buckets << "\n\n";
+
+    o << "low bits | entropy | ratio\n";
+
+    for (std::size_t b {1}; b <= low_bit_entropy.size(); ++b) {
+        o << std::setw(8) << b << " | " << std::setw(7) << low_bit_entropy[b - 1] << " | ";
+        o << std::setw(5) << low_bit_entropy[b - 1] / static_cast<double>(b) << "\n";
+    }
+
+    o << "\nbit | share of ones\n";
+
+    for (std::size_t i {0}; i < bit_bias.size() && i < 16; ++i) {
+        o << std::setw(3) << i << " | " << std::setw(5) << bit_bias[i] << "\n";
+    }
+
+    o << "\nbucket size | actual buckets | expected buckets\n";
+
+    for (std::size_t k {0}; k < actual_bucket_sizes.size(); ++k) {
+        if (actual_bucket_sizes[k] == 0 && expected_bucket_sizes[k] < 0.5) continue;
+
+        o << std::setw(11) << k << " | " << std::setw(14) << std::setprecision(0) << actual_bucket_sizes[k] << " | ";
+        o << std::setw(16) << std::setprecision(1) << expected_bucket_sizes[k] << "\n";
+    }
+
+    o << std::setprecision(3);
+    o << "\ndistance to expected bucket sizes = " << distance << "\n";
+
+    if (recommend_mixing) {
+        o << "recommendation: the hash is weak in its low bits, use ADS_mix_hash<Key, Hash>\n";
+    } else {
+        o << "recommendation: the hash is suitable for linear hashing\n";
+    }
+}
+
+#endif // ADS_HASH_ANALYZER_H
@@ -3,17 +3,150 @@
 
 #include <functional>
 #include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+
+#include "ADS_frozen_set.h"
+#include "ADS_hash.h"
+#include "ADS_simd.h"
+
+/**
+ * Default policy of ADS_set. Optional features are enabled by deriving from
+ * it and redeclaring the respective members.
+ */
+struct ADS_default_policy {
+    /**
+     * Bits per value of the membership filter, 0 disables the filter.
+     *
+     * The filter is a blocked Bloom filter checked before the bucket, so most
+     * lookups of absent keys never touch the table. 8 bits per value reject
+     * about 97% of them.
+     */
+    static constexpr size_t filter_bits {0};
+
+    /**
+     * Values stored within the set object, 0 disables inline storage.
+     *
+     * A set with inline storage uses a single bucket of that many values
+     * inside the object and allocates no memory until it outgrows it.
+     */
+    static constexpr size_t inline_values {0};
+
+    /**
+     * Whether snapshot() is available.
+     *
+     * Value arrays then carry a reference count, so snapshots can share them
+     * with the set until either side modifies a bucket. Incompatible with
+     * inline_values.
+     */
+    static constexpr bool snapshots {false};
+
+    /**
+     * Bucket size beyond which inserts split ahead, 0 disables the guard.
+     *
+     * Linear hashing splits buckets in order, not the one that overflows, so
+     * skewed keys can grow single buckets long. An insert into a bucket with
+     * more values splits up to 32 further buckets until it is split, unless
+     * the table would drop below a quarter of its capacity.
+     */
+    static constexpr size_t chain_limit {0};
+
+    /**
+     * Whether the table grows by partial expansions (Larson) instead of
+     * doubling in one pass. Incompatible with inline_values.
+     *
+     * Each split round doubles the table in two passes: groups of two
+     * buckets grow to three, then to four buckets, each growth moving a
+     * third or a quarter of the group's values to the new bucket. Buckets
+     * stay more evenly loaded than with one pass, where split buckets hold
+     * half as many values as unsplit ones. Addressing a bucket takes two
+     * address bits and one mixing step.
+     */
+    static constexpr bool partial_expansions {false};
+
+    /**
+     * Bucket size that makes an insert rehash the set with a new seed, 0
+     * disables seeded hashing.
+     *
+     * Each set mixes a random seed into hash values before addressing
+     * buckets, so keys that flood single buckets cannot be chosen without
+     * knowing the seed. If a bucket still grows beyond the limit, the set
+     * draws a new seed and moves values to their new buckets a few buckets
+     * per insert and erase. The set reseeds at most once per doubling, so
+     * keys of equal hash values do not make it rehash over and over.
+     */
+    static constexpr size_t reseed_limit {0};
+
+    /**
+     * Whether each key has a second bucket, addressed by independent hash
+     * bits, and is inserted into the less loaded of its two buckets.
+     * Incompatible with chain_limit and reseed_limit.
+     *
+     * This bounds the longest bucket, and so the worst case lookup, to
+     * about half the length of one choice. It pays off for keys whose hash
+     * values share their low bits, which one choice piles into few buckets
+     * while their second buckets spread them over the table. For evenly
+     * spread hash values splits follow full buckets, so the table settles
+     * at a similar load with as many overflow pages. Lookups of keys not in
+     * their first bucket, and of absent keys, probe both buckets and are
+     * slower on average.
+     */
+    static constexpr bool two_choice {false};
+
+    /**
+     * Whether touch() moves found values towards the front of their bucket.
+     *
+     * A hit swaps the value with the one halfway to the front, so keys
+     * looked up often reach the first cache line of their bucket within a
+     * few lookups, while a rare key displaces a value at the front only
+     * from the second position. find() and count() stay pure lookups;
+     * touch() modifies the set and invalidates iterators into the bucket
+     * of the touched key.
+     */
+    static constexpr bool promote_hits {false};
+
+    /**
+     * Whether buckets keep their values ordered by hash value, for buckets
+     * of many values. Incompatible with partial_expansions, reseed_limit
+     * and promote_hits.
+     *
+     * Lookups binary-search the hash value and compare only the values of
+     * equal hash, while inserts and erasures shift the values behind. A
+     * split moves the values of the next hash bit to an empty bucket in
+     * order, so both buckets stay sorted without sorting them again. The
+     * hash is recomputed for each probed value, unless values are stored as
+     * their hash.
+     */
+    static constexpr bool sorted_buckets {false};
+};
 
 /**
  * Set implemented with Linear hashing scheme.
  *
+ * If Hash is bijective (see ADS_bijective_hash), values are stored as their
+ * hash and reverted on access, so splitting never needs to rehash them.
+ * Iterators then return keys by value and are only input iterators.
+ *
+ * Empty sets hold no memory; the table is allocated on the first insert.
+ *
+ * With N set to 0 the bucket size is chosen at runtime by the constructor,
+ * so it can come from configuration. A fixed N lets the compiler fold it.
+ *
  * @tparam Key key type
- * @tparam N size of the buckets (b in lectures)
+ * @tparam N size of the buckets (b in lectures), 0 to set it by the constructor
+ * @tparam Hash hash function object type
+ * @tparam Policy optional features, see ADS_default_policy
  */
-template<typename Key, size_t N = 5>
+template<typename Key, size_t N = 5, typename Hash = std::hash<Key>, typename Policy = ADS_default_policy>
 class ADS_set {
 public:
     class Bucket;
@@ -29,7 +162,7 @@ public:
     using const_iterator = Iterator;
     using iterator = const_iterator;
     using key_equal = std::equal_to<key_type>;
-    using hasher = std::hash<key_type>;
+    using hasher = Hash;
 private:
     /** Split round (d in lectures) */
     size_type split_round {0};
@@ -49,14 +182,226 @@ private:
     /** Hash instance */
     const hasher hash {};
 
+    /** Whether values are stored as their hash, iterators then return keys by value and are input iterators */
+    static constexpr bool stores_hash {ADS_is_bijective_hash<hasher>::value};
+
+    /** Whether the membership filter is enabled */
+    static constexpr bool has_filter {Policy::filter_bits > 0};
+
+    /** Whether hash values are mixed with a seed of the set */
+    static constexpr bool seeded_hash {Policy::reseed_limit > 0};
+
+    /** Whether keys may be placed in a second bucket */
+    static constexpr bool two_choice {Policy::two_choice};
+
+    /** Amount of buckets a rehash moves per insert or erase */
+    static constexpr size_type rehash_step_buckets {4};
+
+    /** Whether the set starts with a bucket of inline storage */
+    static constexpr bool has_inline_table {Policy::inline_values > 0};
+
+    static_assert(!(has_inline_table && Policy::snapshots), "inline storage cannot be shared by snapshots");
+
+    static_assert(!(has_inline_table && Policy::partial_expansions), "partial expansions start with a group of two buckets");
+
+    static_assert(!(two_choice && Policy::chain_limit > 0), "two choices already bound the bucket sizes");
+
+    static_assert(!(two_choice && seeded_hash), "a rehash cannot tell which of its buckets a value was placed in");
+
+    static_assert(!(Policy::sorted_buckets && Policy::partial_expansions), "partial expansions merge values of several buckets");
+
+    static_assert(!(Policy::sorted_buckets && seeded_hash), "a rehash appends values to buckets out of order");
+
+    static_assert(!(Policy::sorted_buckets && Policy::promote_hits), "promoting hits reorders sorted buckets");
+
+    /** Bucket size of default constructed sets with a runtime bucket size */
+    static constexpr size_type default_page_size {5};
+
+    /** Amount of buckets of an empty set's first table */
+    static constexpr size_type initial_table_size {Policy::partial_expansions ? 2 : 1};
+
+    /** Bucket that uses values stored within the set object as its storage */
+    struct Inline_table {
+        Bucket bucket;
+
+        value_type values[has_inline_table ? Policy::inline_values : 1];
+    };
+
+    /** Placeholder if the set has no inline storage */
+    struct No_inline_table {};
+
+    /** Inline storage, the table while the set has not been split yet */
+    [[no_unique_address]] std::conditional_t<has_inline_table, Inline_table, No_inline_table> inline_table;
+
+    /** State of a set with seeded hashing */
+    struct Reseed_state {
+        /** Seed mixed into hash values before addressing buckets */
+        std::uint64_t seed {0};
+
+        /** Seed that addresses the values a rehash has not moved yet */
+        std::uint64_t old_seed {0};
+
+        /** Index of the next bucket a rehash moves values from */
+        size_type rehash_index {0};
+
+        /** Whether buckets from rehash_index on may hold values addressed by old_seed */
+        bool rehashing {false};
+
+        /** Amount of values when the set was last reseeded */
+        size_type reseed_size {0};
+    };
+
+    /** Placeholder if hash values are not seeded */
+    struct No_reseed_state {};
+
+    /** Seeding state, takes no space unless reseed_limit is set */
+    [[no_unique_address]] std::conditional_t<seeded_hash, Reseed_state, No_reseed_state> reseeding;
+
+    /** Membership filter over the stored hash values */
+    struct Filter {
+        /** Words of the filter */
+        std::uint64_t* words {nullptr};
+
+        /** Number of filter words, zero or a power of two */
+        size_type size {0};
+
+        /** Number of erased values whose bits are still set in the filter */
+        size_type stale {0};
+    };
+
+    /** Placeholder if the set has no filter */
+    struct No_filter {};
+
+    /** Membership filter, takes no space unless filter_bits is set */
+    [[no_unique_address]] std::conditional_t<has_filter, Filter, No_filter> filter;
+
+    /** State of a split round with partial expansions */
+    struct Expansion_state {
+        /** Pass of the split round, groups grow from 2 + pass buckets */
+        size_type pass {0};
+    };
+
+    /** Placeholder if the table doubles in one pass */
+    struct No_expansion_state {};
+
+    /** Partial expansion state, takes no space unless partial_expansions is set */
+    [[no_unique_address]] std::conditional_t<Policy::partial_expansions, Expansion_state, No_expansion_state> expansion;
+
+    /** Bucket size given to the constructor */
+    struct Runtime_page_size {
+        /** Amount of values per bucket and overflow page (see page_size()) */
+        size_type size {default_page_size};
+    };
+
+    /** Placeholder if N fixes the bucket size */
+    struct No_runtime_page_size {};
+
+    /** Bucket size if N is 0, takes no space otherwise */
+    [[no_unique_address]] std::conditional_t<N == 0, Runtime_page_size, No_runtime_page_size> table_page_size;
+
+    /** Whether the table is the inline bucket */
+    bool uses_inline_table() const {
+        if constexpr (has_inline_table) return table == &inline_table.bucket;
+        else return false;
+    }
+
+    /** Bits set per value in the filter, about ln(2) times the bits per value */
+    static constexpr unsigned filter_probes {
+        Policy::filter_bits * 7 / 10 < 1 ? 1 : Policy::filter_bits * 7 / 10 > 5 ? 5 : Policy::filter_bits * 7 / 10
+    };
+
     /** Hash function for current split round */
-    size_type h(const key_type& key) const {
-        return hash(key) % (1 << split_round);
+    size_type h(size_type hash_value) const {
+        return hash_value & ((size_type {1} << split_round) - 1);
     }
 
     /** Hash function for next split round */
-    size_type g(const key_type& key) const {
-        return hash(key) % (1 << (split_round + 1));
+    size_type g(size_type hash_value) const {
+        return hash_value & ((size_type {2} << split_round) - 1);
+    }
+
+    /**
+     * Get the position of an address in its group of buckets in a split
+     * round with partial expansions.
+     *
+     * The two address bits above the group select the position in the group
+     * of four buckets the round ends with, so it is also the position in the
+     * groups of two of the next round. A group of three holds the values of
+     * positions 0 and 1 and two thirds of the values bound for positions 2
+     * and 3 at position 2, drawn by a mix of the address.
+     *
+     * @param address address of the value
+     * @param group_size amount of buckets in the group (2 to 4)
+     * @return position in the group
+     */
+    size_type group_position(size_type address, size_type group_size) const {
+        const size_type low {(address >> split_round) & 1};
+        const size_type high {(address >> (split_round + 1)) & 1};
+
+        if (group_size == 2) return low;
+        if (group_size == 4) return low | high << 1;
+
+        // Each bucket of a group of three holds a third of its values
+        const bool moved_early {(ADS_mix64(address) & 0xffffffff) * 3 >= (std::uint64_t {1} << 32)};
+
+        return high && moved_early ? 2 : low;
+    }
+
+    /** Get the index of the bucket for an address with partial expansions */
+    size_type partial_index(size_type address) const {
+        const size_type group {h(address)};
+        const size_type group_size {(group < table_split_index ? 3 : 2) + expansion.pass};
+
+        return group + (group_position(address, group_size) << split_round);
+    }
+
+    /** Get the address of a hash value under the set's seed */
+    size_type address_of(size_type hash_value) const {
+        if constexpr (seeded_hash) return address_of(hash_value, reseeding.seed);
+        else return hash_value;
+    }
+
+    /** Get the address of a hash value for a seed, the hash value itself without seeding */
+    static size_type address_of(size_type hash_value, [[maybe_unused]] std::uint64_t seed) {
+        if constexpr (seeded_hash) return static_cast<size_type>(ADS_mix64(hash_value ^ seed));
+        else return hash_value;
+    }
+
+    /** Get the address of a key's second bucket from the address of its first */
+    static size_type second_address_of(size_type address) {
+        return static_cast<size_type>(ADS_mix64(address + 0x9e3779b97f4a7c15ULL));
+    }
+
+    /** Get the value stored for a key of the given hash value */
+    static decltype(auto) stored(const key_type& key, [[maybe_unused]] size_type hash_value) {
+        if constexpr (stores_hash) return static_cast<value_type>(hash_value);
+        else return (key);
+    }
+
+    /** Check in debug builds that a caller-supplied hash value is the key's */
+    void assert_hash([[maybe_unused]] const key_type& key, [[maybe_unused]] size_type hash_value) const {
+        assert(hash(key) == hash_value && "hash value does not belong to the key");
+    }
+
+    /** Get the hash of a stored value */
+    size_type stored_hash(const value_type& value) const {
+        if constexpr (stores_hash) return static_cast<std::make_unsigned_t<value_type>>(value);
+        else return hash(value);
+    }
+
+    /**
+     * Get the bucket and index of a key's value.
+     *
+     * @param key the key to find
+     * @param hash_value hash of the key by the set's hasher
+     * @return bucket and index of the value; nullptr and 0 if it wasn't found
+     */
+    std::pair<Bucket*, size_type> position_of(const key_type& key, size_type hash_value) const;
+
+    /** Get the key of a stored value */
+    static decltype(auto) decode(const value_type& value) {
+        if constexpr (stores_hash) return hasher::inverse(static_cast<std::make_unsigned_t<value_type>>(value));
+        else return (value);
     }
 
     /**
@@ -65,7 +410,137 @@ private:
      * @param key the key to probe for
      * @return reference to bucket
      */
-    Bucket& bucket_at(const key_type& key) const;
+    Bucket& bucket_at(const key_type& key) const { return bucket_of(hash(key)); }
+
+    /**
+     * Get the bucket where values of the given hash value should be at.
+     *
+     * @param hash_value hash value to probe for
+     * @return reference to bucket
+     */
+    Bucket& bucket_of(size_type hash_value) const { return table[bucket_index(address_of(hash_value))]; }
+
+    /**
+     * Get the second bucket where values of the given hash value may be at,
+     * the first bucket if keys have no second one.
+     *
+     * @param hash_value hash value to probe for
+     * @return reference to bucket
+     */
+    Bucket& second_bucket_of(size_type hash_value) const {
+        if constexpr (two_choice) return table[bucket_index(second_address_of(address_of(hash_value)))];
+        else return bucket_of(hash_value);
+    }
+
+    /**
+     * Get the bucket a new value of the given hash value is inserted into,
+     * the less loaded of its two buckets, on ties the first one.
+     *
+     * @param hash_value hash value to insert
+     * @return reference to bucket
+     */
+    Bucket& insert_bucket_of(size_type hash_value) const {
+        Bucket& first {bucket_of(hash_value)};
+        Bucket& second {second_bucket_of(hash_value)};
+
+        return second.size() < first.size() ? second : first;
+    }
+
+    /**
+     * Get the index of the bucket for an address (see address_of).
+     *
+     * @param address seeded hash value to probe for
+     * @return index of bucket
+     */
+    size_type bucket_index(size_type address) const;
+
+    /**
+     * Get the bucket a value of the given hash value may still be at while
+     * a rehash has not moved it to bucket_of(hash_value) yet.
+     *
+     * @param hash_value hash value to probe for
+     * @param bucket the bucket of the hash value
+     * @return pointer to bucket; nullptr if there is no other bucket to probe
+     */
+    Bucket* stale_bucket_of([[maybe_unused]] size_type hash_value, [[maybe_unused]] const Bucket& bucket) const {
+        if constexpr (seeded_hash) {
+            if (!reseeding.rehashing) return nullptr;
+
+            const size_type index {bucket_index(address_of(hash_value, reseeding.old_seed))};
+
+            if (index < reseeding.rehash_index || table + index == &bucket) return nullptr;
+
+            return table + index;
+        } else {
+            return nullptr;
+        }
+    }
+
+    /**
+     * Start rehashing with a new seed. Values are moved by rehash_step().
+     */
+    void reseed();
+
+    /**
+     * Move the values of the next rehash_step_buckets buckets to their
+     * buckets under the new seed, ending the rehash after the last bucket.
+     */
+    void rehash_step();
+
+    /**
+     * Move the values of a bucket a rehash has not reached yet to their
+     * buckets under the new seed.
+     *
+     * @param index index of the bucket
+     */
+    void rehash_bucket(size_type index);
+
+    /** Get the filter bits of a hash value, all within one word */
+    static std::uint64_t filter_bits_of(std::uint64_t mixed) {
+        std::uint64_t bits {0};
+
+        for (unsigned i {0}; i < filter_probes; ++i) {
+            bits |= std::uint64_t {1} << ((mixed >> (6 * i)) & 63);
+        }
+
+        return bits;
+    }
+
+    /** Get the filter word of a mixed hash value */
+    size_type filter_word_of(std::uint64_t mixed) const {
+        return static_cast<size_type>(mixed >> 32) & (filter.size - 1);
+    }
+
+    /** Record a hash value in the filter */
+    void filter_add(size_type hash_value) {
+        const std::uint64_t mixed {ADS_mix64(hash_value)};
+
+        filter.words[filter_word_of(mixed)] |= filter_bits_of(mixed);
+    }
+
+    /**
+     * Check the filter for a hash value.
+     *
+     * @param hash_value hash value to check
+     * @return false if no value of the hash value is stored; always true without a filter
+     */
+    bool filter_may_contain(size_type hash_value) const {
+        if constexpr (has_filter) {
+            if (filter.size == 0) return false;
+
+            const std::uint64_t mixed {ADS_mix64(hash_value)};
+            const std::uint64_t bits {filter_bits_of(mixed)};
+
+            return (filter.words[filter_word_of(mixed)] & bits) == bits;
+        } else {
+            return true;
+        }
+    }
+
+    /**
+     * Reallocate the filter for twice the stored values and record all of them.
+     */
+    void rebuild_filter();
 
     /**
      * Allocates the given amount of buckets for the hash table.
@@ -80,12 +555,53 @@ private:
      */
     void split();
 
+    /** Maximum amount of splits per insert to shorten a long bucket */
+    static constexpr size_type chain_split_budget {32};
+
+    /**
+     * Split ahead while the bucket of a hash value holds more than
+     * Policy::chain_limit values, bounded by chain_split_budget and the load.
+     *
+     * @param hash_value hash value addressing the long bucket
+     * @return whether any bucket was split
+     */
+    bool split_towards(size_type hash_value);
+
+    /**
+     * Take over the layout of an empty set's values from another set.
+     *
+     * @param other the set to clone
+     * @param share_values whether to share value arrays instead of copying them
+     */
+    void clone(const ADS_set& other, bool share_values);
+
+    /** Tag of the constructor that leaves the seed unset */
+    struct Unseeded {};
+
+    /**
+     * Creates an empty set without drawing a seed, for sets that take their
+     * state from another set. Allocates nothing and cannot throw.
+     */
+    explicit ADS_set(Unseeded) noexcept;
+
 public:
     /**
      * Creates an empty set.
      */
     ADS_set();
 
+    /**
+     * Creates an empty set with the given bucket size. Only exists if N is
+     * 0. Call it with parentheses, braces select the initializer list
+     * constructor.
+     *
+     * @tparam M N, to make the constructor a template that SFINAE can remove
+     * @param page_size amount of values per bucket and overflow page
+     * @throws std::invalid_argument if page_size is 0
+     */
+    template<size_t M = N, std::enable_if_t<M == 0, int> = 0>
+    explicit ADS_set(size_type page_size);
+
     /**
      * Delete the set.
      */
@@ -109,7 +625,7 @@ public:
     ADS_set(std::initializer_list<key_type> ilist);
 
     /**
-     * Creates a copy of a given set.
+     * Creates a copy of a given set with the same buckets and split state.
      *
      * @param other other set to copy from
      */
@@ -144,7 +660,16 @@ public:
      * @param key the key to insert
      * @return iterator for value and boolean whether it was newly added
      */
-    std::pair<iterator, bool> insert(const key_type& key);
+    std::pair<iterator, bool> insert(const key_type& key) { return insert_hashed(key, hash(key)); }
+
+    /**
+     * Insert a given key with its precomputed hash value.
+     *
+     * @param key the key to insert
+     * @param hash_value hash of the key by the set's hasher
+     * @return iterator for value and boolean whether it was newly added
+     */
+    std::pair<iterator, bool> insert_hashed(const key_type& key, size_type hash_value);
 
     /**
      * Insert a range of given keys.
@@ -164,17 +689,54 @@ public:
     void insert(std::initializer_list<key_type> ilist);
 
     /**
-     * Clear all values of the set.
+     * Clear all values of the set, keeping its buckets and their capacity
+     * so refilling it allocates nothing.
      */
     void clear();
 
+    /**
+     * Clear all values of the set and free all of its memory.
+     */
+    void release();
+
+    /**
+     * Free memory that the current values do not need.
+     */
+    void shrink_to_fit();
+
+    /**
+     * Shrink the capacity of all buckets to the fewest pages of values
+     * their values fit in. Buckets shared with snapshots are skipped.
+     */
+    void compact();
+
+    /**
+     * Shrink the capacity of the next few buckets like compact(), so
+     * compaction can be spread over many short calls. The caller keeps the
+     * position of the pass, starting at 0.
+     *
+     * @param cursor index of the next bucket to rewrite, advanced by the call and reset to 0 after the last bucket
+     * @param buckets maximum amount of buckets to rewrite
+     * @return whether all buckets have been rewritten since the pass started
+     */
+    bool compact_step(size_type& cursor, size_type buckets);
+
     /**
      * Removes the given key from the hash table.
      *
      * @param key the key to remove
      * @return the amount of removed elements
      */
-    size_type erase(const key_type& key);
+    size_type erase(const key_type& key) { return erase_hashed(key, hash(key)); }
+
+    /**
+     * Removes the given key with its precomputed hash value.
+     *
+     * @param key the key to remove
+     * @param hash_value hash of the key by the set's hasher
+     * @return the amount of removed elements
+     */
+    size_type erase_hashed(const key_type& key, size_type hash_value);
 
     /**
      * Count how many times a key exists in the set (0 or 1).
@@ -182,7 +744,16 @@ public:
      * @param key the key to count for
      * @return how many times the key exists (0 or 1)
      */
-    size_type count(const key_type& key) const;
+    size_type count(const key_type& key) const { return count_hashed(key, hash(key)); }
+
+    /**
+     * Count a key with its precomputed hash value (0 or 1).
+     *
+     * @param key the key to count for
+     * @param hash_value hash of the key by the set's hasher
+     * @return how many times the key exists (0 or 1)
+     */
+    size_type count_hashed(const key_type& key, size_type hash_value) const;
 
     /**
      * Finds the given key's value in the hash table.
@@ -190,7 +761,35 @@ public:
      * @param key the key to find
      * @return iterator of found value; if nothing was found the end iterator
      */
-    iterator find(const key_type& key) const;
+    iterator find(const key_type& key) const { return find_hashed(key, hash(key)); }
+
+    /**
+     * Finds a key's value with its precomputed hash value.
+     *
+     * @param key the key to find
+     * @param hash_value hash of the key by the set's hasher
+     * @return iterator of found value; if nothing was found the end iterator
+     */
+    iterator find_hashed(const key_type& key, size_type hash_value) const;
+
+    /**
+     * Finds the given key's value like find(), and moves it towards the
+     * front of its bucket if the policy enables promote_hits. Invalidates
+     * iterators into the key's bucket, which may then refer to other values.
+     *
+     * @param key the key to find
+     * @return iterator of found value; if nothing was found the end iterator
+     */
+    iterator touch(const key_type& key) { return touch_hashed(key, hash(key)); }
+
+    /**
+     * Touches a key's value with its precomputed hash value (see touch()).
+     *
+     * @param key the key to find
+     * @param hash_value hash of the key by the set's hasher
+     * @return iterator of found value; if nothing was found the end iterator
+     */
+    iterator touch_hashed(const key_type& key, size_type hash_value);
 
     /**
      * Swap this set with the given other set.
@@ -199,6 +798,28 @@ public:
      */
     void swap(ADS_set& other);
 
+    /**
+     * Create an immutable copy of the set with a minimal perfect hash, so
+     * every lookup probes exactly one slot.
+     *
+     * @return frozen copy of the set
+     * @throws std::invalid_argument if two distinct keys have the same hash value
+     */
+    ADS_frozen_set<key_type, hasher> freeze() const {
+        // Iterators over keys stored as their hash are input iterators, so copy them in one pass
+        return {begin(), end(), size()};
+    }
+
+    /**
+     * Create a copy of the set that shares all buckets with it. A bucket is
+     * copied once the set or the snapshot modifies it, so taking a snapshot
+     * only copies the table of buckets. Other threads may read the snapshot
+     * while this set is modified. Requires a policy with snapshots enabled.
+     *
+     * @return snapshot of the set
+     */
+    ADS_set snapshot() const;
+
     /**
      * Get the iterator to the first item in the hash table.
      *
@@ -228,11 +849,59 @@ public:
     [[nodiscard]] bool empty() const { return table_items_size == 0; };
 
     /**
-     * Dump the set's content to a given stream.
+     * Get the amount of buckets in use by the current split state.
      *
-     * @param o the stream to dump to
+     * @return amount of addressable buckets
      */
-    void dump(std::ostream& o = std::cerr) const;
+    [[nodiscard]] size_type bucket_count() const {
+        if (table_size == 0) return 0;
+
+        if constexpr (Policy::partial_expansions) return ((2 + expansion.pass) << split_round) + table_split_index;
+        else return (size_type {1} << split_round) + table_split_index;
+    };
+
+    /**
+     * Get the index of the bucket a key is addressed to.
+     *
+     * @param key the key to address
+     * @return index of the key's bucket
+     */
+    [[nodiscard]] size_type bucket(const key_type& key) const { return table_size == 0 ? 0 : &bucket_at(key) - table; };
+
+    /**
+     * Get the amount of values stored in the bucket at the given index.
+     *
+     * @param index index of the bucket
+     * @return amount of values stored in that bucket
+     */
+    [[nodiscard]] size_type bucket_size(size_type index) const { return table[index].size(); };
+
+    /**
+     * Get the amount of values per bucket and overflow page.
+     *
+     * @return N, or the size given to the constructor if N is 0
+     */
+    [[nodiscard]] size_type page_size() const {
+        if constexpr (N > 0) return N;
+        else return table_page_size.size;
+    };
+
+    /**
+     * Get the amount of bucket splits performed since construction.
+     *
+     * @return amount of performed splits
+     */
+    [[nodiscard]] size_type split_count() const {
+        // Every split adds one bucket to the table's initial ones
+        return table_size == 0 ? 0 : bucket_count() - initial_table_size;
+    };
+
+    /**
+     * Dump the set's content to a given stream.
+     *
+     * @param o the stream to dump to
+     */
+    void dump(std::ostream& o = std::cerr) const;
 
     friend bool operator==(const ADS_set& lhs, const ADS_set& rhs) {
         if (lhs.table_items_size != rhs.table_items_size) return false;
@@ -249,8 +918,8 @@ public:
     }
 };
 
-template<typename Key, size_t N>
-class ADS_set<Key, N>::Bucket {
+template<typename Key, size_t N, typename Hash, typename Policy>
+class ADS_set<Key, N, Hash, Policy>::Bucket {
     /** Amount of stored values */
     size_type values_size {0};
 
@@ -260,16 +929,102 @@ class ADS_set<Key, N>::Bucket {
     /** Array of values */
     value_type* values {nullptr};
 
+    /** Whether values need no construction or destruction and can be moved bytewise */
+    static constexpr bool trivial_values {std::is_trivial_v<value_type>};
+
+    /** Whether values are 32 or 64 bit integers, compared with vector instructions */
+    static constexpr bool simd_values {ADS_simd_searchable<value_type>};
+
+    /** Whether value arrays can be shared with snapshots */
+    static constexpr bool shared_values {Policy::snapshots};
+
+    /** Whether values are ordered by their hash value */
+    static constexpr bool sorted_values {Policy::sorted_buckets};
+
+    /** Get the hash value a sorted bucket orders a value by */
+    static size_type order_of(const value_type& value) {
+        if constexpr (stores_hash) return static_cast<std::make_unsigned_t<value_type>>(value);
+        else return hasher {}(value);
+    }
+
+    /**
+     * Get the index of the first value not ordered before a hash value in a
+     * sorted bucket.
+     *
+     * @param order hash value to search for
+     * @return index of the first value of at least that hash value
+     */
+    size_type lower_bound(size_type order) const;
+
+    /** Header in front of value arrays that can be shared */
+    struct Page_header {
+        /** Amount of buckets using the array */
+        std::atomic<size_type> references;
+
+        /** Amount of values in the array */
+        size_type capacity;
+    };
+
+    static_assert(!shared_values || alignof(value_type) <= alignof(std::max_align_t), "Shared values must not be over-aligned");
+
+    /** Size of the header rounded up to the alignment of values */
+    static constexpr size_type header_size {(sizeof(Page_header) + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type)};
+
+    /** Get the header of a shared value array */
+    static Page_header* header_of(value_type* values) {
+        return reinterpret_cast<Page_header*>(reinterpret_cast<char*>(values) - header_size);
+    }
+
+    /**
+     * Get whether the values are shared with a bucket of another set.
+     *
+     * @return if values are shared
+     */
+    bool is_shared() const;
+
+    /**
+     * Copy shared values, so the bucket can modify them.
+     */
+    void unshare();
+
+    /**
+     * Allocate an array for the given amount of values.
+     *
+     * @param capacity amount of values
+     * @return pointer to the array
+     */
+    static value_type* allocate(size_type capacity);
+
+    /**
+     * Move the first values of an array to a newly sized array and free the old one.
+     * Trivial values are grown in place if possible.
+     *
+     * @param values array to resize
+     * @param size amount of values to keep
+     * @param capacity new amount of values
+     * @return pointer to the resized array
+     */
+    static value_type* reallocate(value_type* values, size_type size, size_type capacity);
+
     /**
-     * Expand the capacity of Bucket by N values.
+     * Free an array allocated by allocate() or reallocate().
+     *
+     * @param values array to free
      */
-    void expand();
+    static void deallocate(value_type* values);
+
+    /**
+     * Expand the capacity of Bucket by a page of values.
+     *
+     * @param page amount of values per page
+     */
+    void expand(size_type page);
 
 public:
     /**
-     * Creates an empty bucket.
+     * Creates an empty bucket. Memory for values is allocated on first insert.
      */
-    Bucket();
+    Bucket() = default;
 
     /**
      * Delete this bucket.
@@ -330,13 +1085,90 @@ public:
      */
     value_type* locate(const key_type& key) const;
 
+    /**
+     * Swap the value at an index with the value halfway to the front.
+     *
+     * @param index index of the value to promote
+     * @return the index the value was moved to
+     */
+    size_type promote(size_type index);
+
     /**
      * Push a key to the bucket.
      *
      * @param key the key to insert
+     * @param page amount of values per page, if the bucket needs to grow
      * @return the index where the key was added at.
      */
-    std::pair<size_type, bool> insert(key_type key);
+    std::pair<size_type, bool> insert(key_type key, size_type page);
+
+    /**
+     * Push a key to the bucket without checking whether it already exists.
+     * Sorted buckets require the key not to be ordered before any value.
+     *
+     * @param key the key to push
+     * @param page amount of values per page, if the bucket needs to grow
+     */
+    void push(key_type key, size_type page);
+
+    /**
+     * Remove all values, keeping the allocated capacity.
+     */
+    void clear();
+
+    /**
+     * Store values in the given array owned by someone else. The bucket
+     * neither grows nor frees it until detach() is called.
+     *
+     * @param storage array of values
+     * @param capacity amount of values in the array
+     */
+    void attach(value_type* storage, size_type capacity);
+
+    /**
+     * Stop using the array given to attach(), leaving the bucket empty.
+     */
+    void detach();
+
+    /**
+     * Use the values of another bucket until either bucket modifies them.
+     * Without snapshots enabled by the policy, the values are copied.
+     *
+     * @param other the bucket to share values with
+     */
+    void share(const Bucket& other);
+
+    /**
+     * Swap the values of two buckets with attached arrays of equal capacity,
+     * each bucket keeping its array.
+     *
+     * @param other the bucket to swap values with
+     */
+    void swap_values(Bucket& other);
+
+    /**
+     * Move all values the predicate holds for to another bucket. Both
+     * buckets keep the order of their values, so a sorted bucket split into
+     * an empty one leaves both sorted.
+     *
+     * @tparam Predicate type of predicate
+     * @param other the bucket to move values to
+     * @param page amount of values per page, if the other bucket needs to grow
+     * @param moves predicate whether a value should be moved
+     */
+    template<typename Predicate>
+    void split_into(Bucket& other, size_type page, Predicate moves);
+
+    /**
+     * Move each value to the bucket a function returns for it, keeping
+     * the values it returns this bucket for.
+     *
+     * @tparam Destination type of function
+     * @param page amount of values per page, if other buckets need to grow
+     * @param destination function returning a pointer to a value's bucket
+     */
+    template<typename Destination>
+    void scatter(size_type page, Destination destination);
 
     /**
      * Count how many times a key exists in the bucket (0 or 1 times):
@@ -354,6 +1186,24 @@ public:
      */
     size_type erase(const key_type& key);
 
+    /**
+     * Free capacity beyond one free page once at least two pages are free,
+     * so overflow pages are returned after mass erasure while alternating
+     * inserts and erasures do not reallocate each time.
+     * Must not be called on attached storage.
+     *
+     * @param page amount of values per page
+     */
+    void release_overflow(size_type page);
+
+    /**
+     * Shrink the capacity to the fewest pages that fit the values.
+     * Must not be called on attached storage.
+     *
+     * @param page amount of values per page
+     */
+    void compact(size_type page);
+
     /**
      * Swap this bucket with the given other bucket.
      *
@@ -380,27 +1230,45 @@ public:
      *
      * @return if bucket is full
      */
-    [[nodiscard]] size_type full() const { return values_size == values_capacity; }
+    [[nodiscard]] size_type full() const { return values_capacity != 0 && values_size == values_capacity; }
+
+    /**
+     * Start loading the first values into the cache, so probing another
+     * bucket meanwhile overlaps both memory accesses.
+     */
+    void prefetch() const { __builtin_prefetch(values); }
 
     /**
      * Dump the bucket's content to a given stream.
      *
+     * @param page amount of values per page
      * @param o the stream to dump to
      */
-    void dump(std::ostream& o = std::cerr) const;
+    void dump(size_type page, std::ostream& o = std::cerr) const;
 };
 
-template<typename Key, size_t N>
-class ADS_set<Key, N>::Iterator {
+template<typename Key, size_t N, typename Hash, typename Policy>
+class ADS_set<Key, N, Hash, Policy>::Iterator {
 public:
     using value_type = Key;
     using difference_type = std::ptrdiff_t;
-    using reference = const value_type&;
-    using pointer = const value_type*;
-    using iterator_category = std::forward_iterator_tag;
+
+    /** Decoded keys are returned by value, which forward iterators must not do */
+    using iterator_category = std::conditional_t<stores_hash, std::input_iterator_tag, std::forward_iterator_tag>;
 private:
-    using bucket_pointer = typename ADS_set<Key, N>::Bucket*;
-    using bucket_size_type = typename ADS_set<Key, N>::size_type;
+    /** Holds a decoded key for operator-> when values are stored as their hash */
+    struct Arrow {
+        value_type value;
+
+        const value_type* operator->() const { return &value; }
+    };
+
+public:
+    using reference = std::conditional_t<stores_hash, value_type, const value_type&>;
+    using pointer = std::conditional_t<stores_hash, Arrow, const value_type*>;
+private:
+    using bucket_pointer = typename ADS_set<Key, N, Hash, Policy>::Bucket*;
+    using bucket_size_type = typename ADS_set<Key, N, Hash, Policy>::size_type;
 
     /** Pointer to current bucket */
     bucket_pointer current {nullptr};
@@ -449,221 +1317,671 @@ public:
     }
 };
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::Bucket& ADS_set<Key, N>::bucket_at(const key_type& key) const {
-    size_type index {h(key)};
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::size_type ADS_set<Key, N, Hash, Policy>::bucket_index(size_type address) const {
+    if constexpr (Policy::partial_expansions) return partial_index(address);
+
+    size_type index {h(address)};
 
     // Use next split round's hash function for already split buckets
     if (index < table_split_index) {
-        index = g(key);
+        index = g(address);
+    }
+
+    return index;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::reseed() {
+    reseeding.old_seed = reseeding.seed;
+    reseeding.seed = ADS_random_seed();
+    reseeding.rehash_index = 0;
+    reseeding.rehashing = true;
+    reseeding.reseed_size = table_items_size;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::rehash_step() {
+    for (size_type step {0}; step < rehash_step_buckets && reseeding.rehash_index < bucket_count(); ++step) {
+        rehash_bucket(reseeding.rehash_index);
+        ++reseeding.rehash_index;
     }
 
-    return table[index];
+    // Buckets beyond the ones addressed hold no values of the old seed
+    if (reseeding.rehash_index >= bucket_count()) reseeding.rehashing = false;
 }
 
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::rehash_bucket(size_type index) {
+    if constexpr (seeded_hash) {
+        if (!reseeding.rehashing || index < reseeding.rehash_index) return;
 
-template<typename Key, size_t N>
-void ADS_set<Key, N>::reserve(size_type new_table_size) {
+        // Values already addressed by the new seed stay in place
+        table[index].scatter(page_size(), [this](const value_type& value) {
+            return &bucket_of(stored_hash(value));
+        });
+
+        // Spare capacity would defer the splits an insert into a full bucket triggers
+        if (!uses_inline_table()) table[index].release_overflow(page_size());
+    }
+}
+
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::rebuild_filter() {
+    // Round the words for twice the stored values up to a power of two
+    const size_type needed_bits {2 * (table_items_size + 1) * Policy::filter_bits};
+    size_type new_filter_size {1};
+
+    while (new_filter_size * 64 < needed_bits) new_filter_size <<= 1;
+
+    std::uint64_t* new_filter {new std::uint64_t[new_filter_size] {}};
+
+    delete[] filter.words;
+    filter.words = new_filter;
+    filter.size = new_filter_size;
+    filter.stale = 0;
+
+    for (const auto& key: *this) {
+        filter_add(hash(key));
+    }
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::reserve(size_type new_table_size) {
     // Ignore calls that request making the table smaller
     if (table_size >= new_table_size) return;
 
     // Reserve memory for the new_table's buckets
     Bucket* new_table {new Bucket[new_table_size]};
 
-    // Copy current table content to new_table
-    for (size_type i {0}; i < table_size; ++i) {
-        new_table[i] = std::move(table[i]);
-    }
+    if (uses_inline_table()) {
+        // The inline storage stays with the set, so its values are moved one by one
+        for (size_type i {0}; i < table[0].size(); ++i) {
+            new_table[0].push(std::move(table[0][i]), page_size());
+        }
+
+        table[0].clear();
+    } else {
+        // Copy current table content to new_table
+        for (size_type i {0}; i < table_size; ++i) {
+            new_table[i] = std::move(table[i]);
+        }
 
-    delete[] table;
+        delete[] table;
+    }
 
     // Update table to new_table
     table = std::move(new_table);
     table_size = new_table_size;
 }
 
-template<typename Key, size_t N>
-void ADS_set<Key, N>::split() {
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::split() {
+    if constexpr (Policy::partial_expansions) {
+        const size_type round_size {size_type {1} << split_round};
+        const size_type group {table_split_index};
+        const size_type group_size {2 + expansion.pass};
+        const size_type new_bucket {group + group_size * round_size};
+
+        // The round ends with four buckets per group
+        if (table_size <= new_bucket) reserve(round_size << 2);
+
+        // Values addressed by the old seed of a rehash cannot be told apart by the new state
+        for (size_type position {0}; position < group_size; ++position) {
+            rehash_bucket(group + position * round_size);
+        }
+
+        if (++table_split_index == round_size) {
+            // Advance the pass, and the split round after the second pass
+            table_split_index = 0;
+
+            if (++expansion.pass == 2) {
+                expansion.pass = 0;
+                ++split_round;
+            }
+        }
+
+        // With the state advanced, each value of the group moves to its bucket after the split
+        for (size_type position {0}; position < group_size; ++position) {
+            const size_type source {group + position * round_size};
+
+            table[source].scatter(page_size(), [this, source](const value_type& value) {
+                const size_type address {address_of(stored_hash(value))};
+
+                // A value stays if either of its buckets is still the one it is in
+                if constexpr (two_choice) {
+                    if (partial_index(second_address_of(address)) == source) return table + source;
+                }
+
+                return table + partial_index(address);
+            });
+        }
+
+        return;
+    }
+
     // Calculate maximum table_size for this split round
-    const size_type max_table_size {1u << split_round};
+    const size_type max_table_size {size_type {1} << split_round};
 
-    // Double the table size
-    if (table_size == max_table_size) {
-        reserve(table_size << 1);
+    // Double the table size if the new bucket does not fit
+    if (table_size <= max_table_size + table_split_index) {
+        reserve(max_table_size << 1);
     }
 
-    // Remove values from bucket to be split by moving bucket
-    Bucket bucket {std::move(table[table_split_index])};
+    // Values addressed by the old seed of a rehash cannot be told apart by the next round's hash function
+    rehash_bucket(table_split_index);
+
+    // Move values that the next split round's hash function addresses to the new bucket
+    table[table_split_index].split_into(table[table_split_index + max_table_size], page_size(), [this, max_table_size](const value_type& value) {
+        const size_type address {address_of(stored_hash(value))};
 
-    // Decrement the total items size by what has been removed by the bucket move
-    table_items_size -= bucket.size();
+        if constexpr (two_choice) {
+            // A value stays if either of its buckets is still the split bucket after the split
+            auto stays = [this, max_table_size](size_type choice) {
+                return h(choice) == table_split_index && (choice & max_table_size) == 0;
+            };
 
-    if (table_split_index >= max_table_size) {
+            return !stays(address) && !stays(second_address_of(address));
+        } else {
+            return (address & max_table_size) != 0;
+        }
+    });
+
+    if (++table_split_index == max_table_size) {
         // Advance split round if all buckets have been split
         table_split_index = 0;
         ++split_round;
-    } else {
-        // Else just advance split index
-        ++table_split_index;
     }
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+bool ADS_set<Key, N, Hash, Policy>::split_towards(size_type hash_value) {
+    size_type splits {0};
+
+    // Each split advances the split index, until it reaches and splits the long bucket
+    while (splits < chain_split_budget && bucket_of(hash_value).size() > Policy::chain_limit) {
+        // Keys that splitting cannot separate must not grow the table without bound
+        if (table_items_size * 4 < bucket_count() * page_size()) break;
 
-    // Add removed values back to set
-    for (size_type i {0}; i < bucket.size(); ++i) {
-        insert(bucket[i]);
+        split();
+        ++splits;
     }
+
+    return splits > 0;
 }
 
-template<typename Key, size_t N>
-ADS_set<Key, N>::ADS_set() : split_round {1}, table_size {1u << split_round}, table {new Bucket[table_size]} {}
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>::ADS_set() : ADS_set {Unseeded {}} {
+    if constexpr (seeded_hash) reseeding.seed = ADS_random_seed();
+}
 
-template<typename Key, size_t N>
-ADS_set<Key, N>::~ADS_set() {
-    delete[] table;
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>::ADS_set(Unseeded) noexcept {
+    // Start with the inline bucket as the single bucket of split round 0
+    if constexpr (has_inline_table) {
+        inline_table.bucket.attach(inline_table.values, Policy::inline_values);
+        table = &inline_table.bucket;
+        table_size = 1;
+    }
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+template<size_t M, std::enable_if_t<M == 0, int>>
+ADS_set<Key, N, Hash, Policy>::ADS_set(size_type page_size) : ADS_set {} {
+    if (page_size == 0) throw std::invalid_argument {"buckets must hold at least one value"};
+
+    table_page_size.size = page_size;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>::~ADS_set() {
+    if (!uses_inline_table()) delete[] table;
+    if constexpr (has_filter) delete[] filter.words;
+
+    if constexpr (has_inline_table) inline_table.bucket.detach();
 }
 
-template<typename Key, size_t N>
+template<typename Key, size_t N, typename Hash, typename Policy>
 template<typename InputIt>
-ADS_set<Key, N>::ADS_set(InputIt first, InputIt last): ADS_set {} {
+ADS_set<Key, N, Hash, Policy>::ADS_set(InputIt first, InputIt last): ADS_set {} {
     insert(first, last);
 }
 
-template<typename Key, size_t N>
-ADS_set<Key, N>::ADS_set(std::initializer_list<key_type> ilist) : ADS_set {ilist.begin(), ilist.end()} {}
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>::ADS_set(std::initializer_list<key_type> ilist) : ADS_set {ilist.begin(), ilist.end()} {}
 
-template<typename Key, size_t N>
-ADS_set<Key, N>::ADS_set(const ADS_set& other) : ADS_set {other.begin(), other.end()} {}
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>::ADS_set(const ADS_set& other) : ADS_set {} {
+    // The other set's layout is valid as is, so clone it instead of inserting every value again
+    clone(other, false);
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy> ADS_set<Key, N, Hash, Policy>::snapshot() const {
+    static_assert(Policy::snapshots, "snapshot() requires a policy with snapshots enabled");
+
+    ADS_set copy;
+    copy.clone(*this, true);
+
+    return copy;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::clone(const ADS_set& other, bool share_values) {
+    if (other.uses_inline_table()) {
+        for (size_type i {0}; i < other.table[0].size(); ++i) {
+            table[0].push(other.table[0][i], page_size());
+        }
+    } else if (other.table_size > 0) {
+        table = new Bucket[other.table_size];
+        table_size = other.table_size;
 
-template<typename Key, size_t N>
-ADS_set<Key, N>::ADS_set(ADS_set&& other) noexcept: ADS_set {} {
+        for (size_type i {0}; i < table_size; ++i) {
+            if (share_values) table[i].share(other.table[i]);
+            else table[i] = other.table[i];
+        }
+    }
+
+    if constexpr (has_filter) {
+        if (other.filter.size > 0) {
+            filter.words = new std::uint64_t[other.filter.size];
+            filter.size = other.filter.size;
+            std::memcpy(filter.words, other.filter.words, filter.size * sizeof(std::uint64_t));
+        }
+
+        filter.stale = other.filter.stale;
+    }
+
+    table_page_size = other.table_page_size;
+    reseeding = other.reseeding;
+    split_round = other.split_round;
+    table_split_index = other.table_split_index;
+    expansion = other.expansion;
+    table_items_size = other.table_items_size;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>::ADS_set(ADS_set&& other) noexcept: ADS_set {Unseeded {}} {
+    // The seed comes with the other set's state, and the other set is left empty with seed 0
     swap(other);
 }
 
-template<typename Key, size_t N>
-ADS_set<Key, N>& ADS_set<Key, N>::operator=(ADS_set other) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>& ADS_set<Key, N, Hash, Policy>::operator=(ADS_set other) {
     swap(other);
 
     return *this;
 }
 
-template<typename Key, size_t N>
-ADS_set<Key, N>& ADS_set<Key, N>::operator=(std::initializer_list<key_type> ilist) {
-    ADS_set tmp {ilist};
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>& ADS_set<Key, N, Hash, Policy>::operator=(std::initializer_list<key_type> ilist) {
+    ADS_set tmp;
+    tmp.table_page_size = table_page_size;
+    tmp.insert(ilist);
     swap(tmp);
 
     return *this;
 }
 
-template<typename Key, size_t N>
-std::pair<typename ADS_set<Key, N>::iterator, bool> ADS_set<Key, N>::insert(const ADS_set::key_type& key) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+std::pair<typename ADS_set<Key, N, Hash, Policy>::iterator, bool>
+ADS_set<Key, N, Hash, Policy>::insert_hashed(const key_type& key, size_type hash_value) {
+    assert_hash(key, hash_value);
+
+    // Allocate the first bucket of an empty set
+    if (table_size == 0) reserve(initial_table_size);
+
+    // Move values before locating the key, so the returned iterator stays valid
+    if constexpr (seeded_hash) {
+        if (reseeding.rehashing) rehash_step();
+    }
+
     // Reference bucket where key should be inserted
-    Bucket* bucket {&bucket_at(key)};
+    Bucket* bucket {&bucket_of(hash_value)};
+
+    // The key might not have been moved by a rehash yet
+    if (Bucket* stale {stale_bucket_of(hash_value, *bucket)}) {
+        const size_type index {stale->index_of(stored(key, hash_value))};
+
+        if (index < stale->capacity()) return {Iterator {stale, table + table_size, index}, false};
+    }
+
+    if constexpr (two_choice) {
+        Bucket* second {&second_bucket_of(hash_value)};
+
+        second->prefetch();
+
+        // The key might be in either bucket, and a split might move it to the bucket not inserting it
+        const size_type first_index {bucket->index_of(stored(key, hash_value))};
 
-    // Split bucket if it's full
+        if (first_index < bucket->capacity()) return {Iterator {bucket, table + table_size, first_index}, false};
+
+        const size_type second_index {second->index_of(stored(key, hash_value))};
+
+        if (second_index < second->capacity()) return {Iterator {second, table + table_size, second_index}, false};
+
+        if (second->size() < bucket->size()) bucket = second;
+    }
+
+    // Split bucket if it's full, with two choices only if both buckets are
     if (bucket->full()) {
         split();
 
         // Insert bucket might need an update after split
-        bucket = &bucket_at(key);
+        bucket = &insert_bucket_of(hash_value);
     }
 
     // Try to insert key in bucket
-    auto [index, added] = bucket->insert(key);
+    auto [index, added] = bucket->insert(stored(key, hash_value), page_size());
 
     // Increment items size if value was added
     if (added) ++table_items_size;
 
+    if constexpr (Policy::chain_limit > 0) {
+        if (added && bucket->size() > Policy::chain_limit && split_towards(hash_value)) {
+            // Splits move the table and values
+            bucket = &bucket_of(hash_value);
+            index = bucket->index_of(stored(key, hash_value));
+        }
+    }
+
+    if constexpr (seeded_hash) {
+        // A long bucket in a table that is not fuller than its bucket size hints at colliding addresses
+        if (added && bucket->size() > Policy::reseed_limit && !reseeding.rehashing && table_items_size > 2 * reseeding.reseed_size &&
+            table_items_size <= bucket_count() * page_size()) {
+            reseed();
+        }
+    }
+
+    if constexpr (has_filter) {
+        if (added) {
+            // Grow the filter once values would get fewer than filter_bits each
+            if (table_items_size * Policy::filter_bits > filter.size * 64) rebuild_filter();
+            else filter_add(hash_value);
+        }
+    }
+
     Iterator it {bucket, table + table_size, index};
 
     return {it, added};
 }
 
-template<typename Key, size_t N>
+template<typename Key, size_t N, typename Hash, typename Policy>
 template<typename InputIt>
-void ADS_set<Key, N>::insert(InputIt first, InputIt last) {
+void ADS_set<Key, N, Hash, Policy>::insert(InputIt first, InputIt last) {
     for (auto it {first}; it != last; ++it) {
         insert(*it);
     }
 }
 
-template<typename Key, size_t N>
-void ADS_set<Key, N>::insert(std::initializer_list<key_type> ilist) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::insert(std::initializer_list<key_type> ilist) {
     insert(ilist.begin(), ilist.end());
 }
 
-template<typename Key, size_t N>
-void ADS_set<Key, N>::clear() {
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::clear() {
+    // Keep the split state, so every bucket is addressed again by the same keys
+    for (size_type i {0}; i < table_size; ++i) {
+        table[i].clear();
+    }
+
+    if constexpr (has_filter) {
+        for (size_type i {0}; i < filter.size; ++i) {
+            filter.words[i] = 0;
+        }
+
+        filter.stale = 0;
+    }
+
+    table_items_size = 0;
+
+    if constexpr (seeded_hash) {
+        // An empty table holds no values of the old seed, and may be reseeded again right away
+        reseeding.rehashing = false;
+        reseeding.rehash_index = 0;
+        reseeding.reseed_size = 0;
+    }
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::release() {
     // Clear all values by creating new empty set and swap them
     ADS_set tmp;
+    tmp.table_page_size = table_page_size;
     swap(tmp);
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::size_type ADS_set<Key, N>::erase(const ADS_set::key_type& key) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::compact() {
+    size_type cursor {0};
+
+    while (!compact_step(cursor, table_size)) {}
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+bool ADS_set<Key, N, Hash, Policy>::compact_step(size_type& cursor, size_type buckets) {
+    // Inline storage cannot shrink
+    if (uses_inline_table()) return true;
+
+    for (; buckets > 0 && cursor < table_size; --buckets, ++cursor) {
+        table[cursor].compact(page_size());
+    }
+
+    if (cursor < table_size) return false;
+
+    // Start the next pass from the first bucket
+    cursor = 0;
+
+    return true;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::shrink_to_fit() {
+    // Reinserting the values builds a table of the size they need
+    ADS_set tmp;
+    tmp.table_page_size = table_page_size;
+    tmp.insert(begin(), end());
+    swap(tmp);
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::size_type
+ADS_set<Key, N, Hash, Policy>::erase_hashed(const key_type& key, size_type hash_value) {
+    assert_hash(key, hash_value);
+
+    if (table_size == 0) return 0;
+
+    if constexpr (seeded_hash) {
+        if (reseeding.rehashing) rehash_step();
+    }
+
     // Reference bucket where key's value should be at
-    Bucket& bucket {bucket_at(key)};
+    Bucket* bucket {&bucket_of(hash_value)};
 
     // Try to erase value from bucket
-    size_type erased {bucket.erase(key)};
+    size_type erased {bucket->erase(stored(key, hash_value))};
+
+    // The key might not have been moved by a rehash yet
+    if (Bucket* stale {erased ? nullptr : stale_bucket_of(hash_value, *bucket)}) {
+        bucket = stale;
+        erased = bucket->erase(stored(key, hash_value));
+    }
+
+    if constexpr (two_choice) {
+        // The key might have been placed in its second bucket
+        if (Bucket* second {&second_bucket_of(hash_value)}; !erased && second != bucket) {
+            bucket = second;
+            erased = bucket->erase(stored(key, hash_value));
+        }
+    }
+
+    // Return overflow pages once they are mostly unused
+    if (erased && !uses_inline_table()) bucket->release_overflow(page_size());
 
     // Decrement amount of items by how much was erased
     table_items_size -= erased;
 
+    if constexpr (has_filter) {
+        // Erased values stay in the filter, rebuild once they outnumber stored values
+        filter.stale += erased;
+
+        if (filter.stale > table_items_size && filter.stale * Policy::filter_bits >= 64) rebuild_filter();
+    }
+
     return erased;
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::size_type ADS_set<Key, N>::count(const key_type& key) const {
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::size_type
+ADS_set<Key, N, Hash, Policy>::count_hashed(const key_type& key, size_type hash_value) const {
+    assert_hash(key, hash_value);
+
+    if (table_size == 0) return 0;
+
+    // Most absent keys are rejected by the filter without touching the table
+    if (!filter_may_contain(hash_value)) return 0;
+
     // Reference where value should be at
-    Bucket& bucket {bucket_at(key)};
+    Bucket& bucket {bucket_of(hash_value)};
+
+    if constexpr (two_choice) {
+        // Load the second bucket while the first is probed
+        Bucket& second {second_bucket_of(hash_value)};
+
+        second.prefetch();
+
+        if (bucket.locate(stored(key, hash_value)) != nullptr) return 1;
+
+        return &second != &bucket && second.locate(stored(key, hash_value)) != nullptr;
+    }
 
     // Check if key could be found in bucket
-    return bucket.locate(key) != nullptr;
+    if (bucket.locate(stored(key, hash_value)) != nullptr) return 1;
+
+    // The key might not have been moved by a rehash yet
+    Bucket* stale {stale_bucket_of(hash_value, bucket)};
+
+    return stale != nullptr && stale->locate(stored(key, hash_value)) != nullptr;
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::iterator ADS_set<Key, N>::find(const key_type& key) const {
+template<typename Key, size_t N, typename Hash, typename Policy>
+std::pair<typename ADS_set<Key, N, Hash, Policy>::Bucket*, typename ADS_set<Key, N, Hash, Policy>::size_type>
+ADS_set<Key, N, Hash, Policy>::position_of(const key_type& key, size_type hash_value) const {
+    assert_hash(key, hash_value);
+
+    if (table_size == 0) return {nullptr, 0};
+
+    // Most absent keys are rejected by the filter without touching the table
+    if (!filter_may_contain(hash_value)) return {nullptr, 0};
+
     // Reference bucket where key's value should be at
-    Bucket* bucket {&bucket_at(key)};
+    Bucket* bucket {&bucket_of(hash_value)};
+
+    if constexpr (two_choice) {
+        // Load the second bucket while the first is probed
+        Bucket* second {&second_bucket_of(hash_value)};
+
+        second->prefetch();
+
+        size_type index {bucket->index_of(stored(key, hash_value))};
+
+        if (index == bucket->capacity() && second != bucket) {
+            bucket = second;
+            index = bucket->index_of(stored(key, hash_value));
+        }
+
+        if (index == bucket->capacity()) return {nullptr, 0};
+
+        return {bucket, index};
+    }
 
     // Check if value with key exists in bucket
-    size_type index {bucket->index_of(key)};
+    size_type index {bucket->index_of(stored(key, hash_value))};
 
-    // Return iterator to the found item
-    if (index < bucket->capacity()) {
-        return Iterator(bucket, table + table_size, index);
+    // The key might not have been moved by a rehash yet
+    if (Bucket* stale {index < bucket->capacity() ? nullptr : stale_bucket_of(hash_value, *bucket)}) {
+        bucket = stale;
+        index = bucket->index_of(stored(key, hash_value));
     }
 
+    if (index < bucket->capacity()) return {bucket, index};
+
+    return {nullptr, 0};
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::iterator
+ADS_set<Key, N, Hash, Policy>::find_hashed(const key_type& key, size_type hash_value) const {
+    const auto [bucket, index] = position_of(key, hash_value);
+
     // If nothing was found return end iterator
-    return end();
+    if (bucket == nullptr) return end();
+
+    return Iterator(bucket, table + table_size, index);
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::iterator
+ADS_set<Key, N, Hash, Policy>::touch_hashed(const key_type& key, size_type hash_value) {
+    auto [bucket, index] = position_of(key, hash_value);
+
+    if (bucket == nullptr) return end();
+
+    if constexpr (Policy::promote_hits) index = bucket->promote(index);
+
+    return Iterator(bucket, table + table_size, index);
 }
 
-template<typename Key, size_t N>
-void ADS_set<Key, N>::swap(ADS_set& other) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::swap(ADS_set& other) {
     using std::swap;
 
+    const bool inline_this {uses_inline_table()};
+    const bool inline_other {other.uses_inline_table()};
+
     swap(split_round, other.split_round);
     swap(table_split_index, other.table_split_index);
     swap(table_size, other.table_size);
+    swap(table_page_size, other.table_page_size);
     swap(table_items_size, other.table_items_size);
+    swap(reseeding, other.reseeding);
     swap(table, other.table);
+    swap(filter, other.filter);
+    swap(expansion, other.expansion);
+
+    if constexpr (has_inline_table) {
+        // Inline values cannot change owners, swap them and point tables to their new owner
+        inline_table.bucket.swap_values(other.inline_table.bucket);
+
+        if (inline_other) table = &inline_table.bucket;
+        if (inline_this) other.table = &other.inline_table.bucket;
+    }
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::const_iterator ADS_set<Key, N>::begin() const {
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::const_iterator ADS_set<Key, N, Hash, Policy>::begin() const {
     return Iterator {table, table + table_size, 0};
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::const_iterator ADS_set<Key, N>::end() const {
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::const_iterator ADS_set<Key, N, Hash, Policy>::end() const {
     auto end {table + table_size};
 
     return Iterator {end, end, 0};
 }
 
-template<typename Key, size_t N>
-void ADS_set<Key, N>::dump(std::ostream& o) const {
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::dump(std::ostream& o) const {
     o << "split_round = " << split_round;
     o << ", table_split_index = " << table_split_index;
+    if constexpr (Policy::partial_expansions) o << ", expansion_pass = " << expansion.pass;
+
+    if constexpr (seeded_hash) {
+        if (reseeding.rehashing) o << ", rehash_index = " << reseeding.rehash_index;
+    }
+
     o << ", table_size = " << table_size;
     o << ", table_items_size = " << table_items_size;
     o << "\n\n";
@@ -671,68 +1989,186 @@ void ADS_set<Key, N>::dump(std::ostream& o) const {
     for (size_type i {0}; i < table_size; ++i) {
         o << (table_split_index == i ? "-> " : "   ");
         o << std::setfill(' ') << std::setw(4) << i << " | ";
-        table[i].dump(o);
+        table[i].dump(page_size(), o);
         o << "\n";
     }
 
     o << "\n";
 }
 
-template<typename Key, size_t N>
-ADS_set<Key, N>::Bucket::Bucket() : values_capacity {N}, values {new value_type[values_capacity]} {}
-
-template<typename Key, size_t N>
-ADS_set<Key, N>::Bucket::~Bucket() {
-    delete[] values;
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>::Bucket::~Bucket() {
+    deallocate(values);
 }
 
-template<typename Key, size_t N>
-ADS_set<Key, N>::Bucket::Bucket(const Bucket& other) : Bucket {} {
-    swap(other);
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>::Bucket::Bucket(const Bucket& other) :
+        values_size {other.values_size}, values_capacity {other.values_capacity},
+        values {other.values_capacity == 0 ? nullptr : allocate(other.values_capacity)} {
+    if constexpr (trivial_values) {
+        if (values_size > 0) std::memcpy(values, other.values, values_size * sizeof(value_type));
+    } else {
+        try {
+            for (size_type i {0}; i < values_size; ++i) {
+                values[i] = other.values[i];
+            }
+        } catch (...) {
+            deallocate(values);
+            throw;
+        }
+    }
 }
 
-template<typename Key, size_t N>
-ADS_set<Key, N>::Bucket::Bucket(Bucket&& other) noexcept: Bucket {} {
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>::Bucket::Bucket(Bucket&& other) noexcept: Bucket {} {
     swap(other);
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::Bucket& ADS_set<Key, N>::Bucket::operator=(Bucket other) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::Bucket& ADS_set<Key, N, Hash, Policy>::Bucket::operator=(Bucket other) {
     swap(other);
 
     return *this;
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::reference ADS_set<Key, N>::Bucket::operator[](size_type index) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::reference ADS_set<Key, N, Hash, Policy>::Bucket::operator[](size_type index) {
     return values[index];
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::const_reference ADS_set<Key, N>::Bucket::operator[](size_type index) const {
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::const_reference ADS_set<Key, N, Hash, Policy>::Bucket::operator[](size_type index) const {
     return values[index];
 }
 
-template<typename Key, size_t N>
-void ADS_set<Key, N>::Bucket::expand() {
-    size_type new_values_capacity {values_size + N};
-    value_type* new_values {new value_type[new_values_capacity]};
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::value_type* ADS_set<Key, N, Hash, Policy>::Bucket::allocate(size_type capacity) {
+    if constexpr (shared_values) {
+        // Place a reference count in front of the values
+        void* memory {std::malloc(header_size + capacity * sizeof(value_type))};
 
-    // Copy/Move values to new_values
-    for (size_type i {0}; i < values_size; ++i) {
-        new_values[i] = std::move(values[i]);
+        if (memory == nullptr) throw std::bad_alloc {};
+
+        auto* values {reinterpret_cast<value_type*>(static_cast<char*>(memory) + header_size)};
+
+        if constexpr (!trivial_values) {
+            size_type constructed {0};
+
+            try {
+                for (; constructed < capacity; ++constructed) {
+                    new (values + constructed) value_type {};
+                }
+            } catch (...) {
+                while (constructed > 0) values[--constructed].~value_type();
+                std::free(memory);
+                throw;
+            }
+        }
+
+        new (memory) Page_header {{1}, capacity};
+
+        return values;
+    } else if constexpr (trivial_values) {
+        void* memory {std::malloc(capacity * sizeof(value_type))};
+
+        if (memory == nullptr) throw std::bad_alloc {};
+
+        return static_cast<value_type*>(memory);
+    } else {
+        return new value_type[capacity];
+    }
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::value_type*
+ADS_set<Key, N, Hash, Policy>::Bucket::reallocate(value_type* values, size_type size, size_type capacity) {
+    if constexpr (trivial_values && !shared_values) {
+        // realloc copies the values itself, if it cannot grow the array in place
+        void* memory {std::realloc(values, capacity * sizeof(value_type))};
+
+        if (memory == nullptr) throw std::bad_alloc {};
+
+        return static_cast<value_type*>(memory);
+    } else {
+        value_type* new_values {allocate(capacity)};
+
+        // Move values to new_values
+        for (size_type i {0}; i < size; ++i) {
+            new_values[i] = std::move(values[i]);
+        }
+
+        deallocate(values);
+
+        return new_values;
     }
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::deallocate(value_type* values) {
+    if constexpr (shared_values) {
+        if (values == nullptr) return;
 
-    // Free memory
-    delete[] values;
+        Page_header* header {header_of(values)};
+
+        // The last bucket using the values frees them
+        if (header->references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+        if constexpr (!trivial_values) {
+            for (size_type i {0}; i < header->capacity; ++i) {
+                values[i].~value_type();
+            }
+        }
+
+        header->~Page_header();
+        std::free(header);
+    } else if constexpr (trivial_values) {
+        std::free(values);
+    } else {
+        delete[] values;
+    }
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::expand(size_type page) {
+    size_type new_values_capacity {values_size + page};
 
     // Update values and capacity
-    values = std::move(new_values);
+    values = reallocate(values, values_size, new_values_capacity);
     values_capacity = new_values_capacity;
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::size_type ADS_set<Key, N>::Bucket::index_of(const ADS_set::key_type& key) const {
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::size_type ADS_set<Key, N, Hash, Policy>::Bucket::lower_bound(size_type order) const {
+    size_type first {0};
+    size_type last {values_size};
+
+    while (first < last) {
+        const size_type middle {first + (last - first) / 2};
+
+        if (order_of(values[middle]) < order) first = middle + 1;
+        else last = middle;
+    }
+
+    return first;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::size_type ADS_set<Key, N, Hash, Policy>::Bucket::index_of(const ADS_set::key_type& key) const {
+    if constexpr (sorted_values) {
+        const size_type order {order_of(key)};
+
+        // Values of equal hash value follow each other in the order they were inserted
+        for (size_type i {lower_bound(order)}; i < values_size && order_of(values[i]) == order; ++i) {
+            if (key_equal {}(values[i], key)) return i;
+        }
+
+        return values_capacity;
+    } else if constexpr (simd_values) {
+        const size_type index {ADS_find_integer(values, values_size, key)};
+
+        return index < values_size ? index : values_capacity;
+    }
+
     for (size_type i {0}; i < values_size; ++i) {
         if (key_equal {}(values[i], key)) {
             return i;
@@ -742,8 +2178,23 @@ typename ADS_set<Key, N>::size_type ADS_set<Key, N>::Bucket::index_of(const ADS_
     return values_capacity;
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::value_type* ADS_set<Key, N>::Bucket::locate(const key_type& key) const {
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::size_type ADS_set<Key, N, Hash, Policy>::Bucket::promote(size_type index) {
+    const size_type front {index / 2};
+
+    if (front != index) {
+        // Snapshots keep the order they were taken with
+        unshare();
+
+        using std::swap;
+        swap(values[front], values[index]);
+    }
+
+    return front;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::value_type* ADS_set<Key, N, Hash, Policy>::Bucket::locate(const key_type& key) const {
     size_type index {index_of(key)};
 
     if (index == values_capacity) return nullptr;
@@ -751,8 +2202,32 @@ typename ADS_set<Key, N>::value_type* ADS_set<Key, N>::Bucket::locate(const key_
     return &values[index];
 }
 
-template<typename Key, size_t N>
-std::pair<typename ADS_set<Key, N>::size_type, bool> ADS_set<Key, N>::Bucket::insert(key_type key) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+std::pair<typename ADS_set<Key, N, Hash, Policy>::size_type, bool> ADS_set<Key, N, Hash, Policy>::Bucket::insert(key_type key, size_type page) {
+    if constexpr (sorted_values) {
+        const size_type order {order_of(key)};
+        size_type index {lower_bound(order)};
+
+        // Ignore insert if key already exists, otherwise insert it after the values of equal hash value
+        for (; index < values_size && order_of(values[index]) == order; ++index) {
+            if (key_equal {}(values[index], key)) return {index, false};
+        }
+
+        unshare();
+
+        if (values_size >= values_capacity) expand(page);
+
+        // Shift the values ordered after the key up by one
+        for (size_type i {values_size}; i > index; --i) {
+            values[i] = std::move(values[i - 1]);
+        }
+
+        values[index] = std::move(key);
+        ++values_size;
+
+        return {index, true};
+    }
+
     size_type index {index_of(key)};
 
     // Ignore insert if key already exists
@@ -760,35 +2235,224 @@ std::pair<typename ADS_set<Key, N>::size_type, bool> ADS_set<Key, N>::Bucket::in
         return {index, false};
     }
 
+    index = values_size;
+    push(std::move(key), page);
+
+    return {index, true};
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::push(key_type key, size_type page) {
+    unshare();
+
     // If size exceeds capacity, expand it
-    if (values_size >= values_capacity) expand();
+    if (values_size >= values_capacity) expand(page);
 
     // Store key and increase bucket's size
-    values[index = values_size++] = std::move(key);
+    values[values_size++] = std::move(key);
+}
 
-    return {index, true};
+template<typename Key, size_t N, typename Hash, typename Policy>
+template<typename Predicate>
+void ADS_set<Key, N, Hash, Policy>::Bucket::split_into(Bucket& other, size_type page, Predicate moves) {
+    unshare();
+
+    size_type kept {0};
+
+    for (size_type i {0}; i < values_size; ++i) {
+        if (moves(values[i])) {
+            other.push(std::move(values[i]), page);
+        } else {
+            // Close the gaps left by moved values
+            if (kept != i) values[kept] = std::move(values[i]);
+            ++kept;
+        }
+    }
+
+    values_size = kept;
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::size_type ADS_set<Key, N>::Bucket::count(const key_type& key) const {
+template<typename Key, size_t N, typename Hash, typename Policy>
+template<typename Destination>
+void ADS_set<Key, N, Hash, Policy>::Bucket::scatter(size_type page, Destination destination) {
+    unshare();
+
+    size_type kept {0};
+
+    for (size_type i {0}; i < values_size; ++i) {
+        Bucket* target {destination(values[i])};
+
+        if (target != this) {
+            target->push(std::move(values[i]), page);
+        } else {
+            // Close the gaps left by moved values
+            if (kept != i) values[kept] = std::move(values[i]);
+            ++kept;
+        }
+    }
+
+    values_size = kept;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::size_type ADS_set<Key, N, Hash, Policy>::Bucket::count(const key_type& key) const {
     return locate(key) != nullptr;
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::size_type ADS_set<Key, N>::Bucket::erase(const ADS_set::key_type& key) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::size_type ADS_set<Key, N, Hash, Policy>::Bucket::erase(const ADS_set::key_type& key) {
     size_type index {index_of(key)};
 
     // Do not erase anything if value couldn't be found
     if (index == values_capacity) return 0;
 
+    // Copies keep the order of values, so index stays valid
+    unshare();
+
+    if constexpr (sorted_values) {
+        // Shift the values behind down by one to keep their order
+        for (size_type i {index + 1}; i < values_size; ++i) {
+            values[i - 1] = std::move(values[i]);
+        }
+
+        --values_size;
+
+        return 1;
+    }
+
     // Replace found value with the last item and decrease bucket's size
     values[index] = std::move(values[--values_size]);
 
     return 1;
 }
 
-template<typename Key, size_t N>
-void ADS_set<Key, N>::Bucket::swap(Bucket& other) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::release_overflow(size_type page) {
+    // Keep one free page, so alternating insert and erase does not reallocate
+    if (values_capacity - values_size < 2 * page || is_shared()) return;
+
+    const size_type new_values_capacity {(values_size + page - 1) / page * page + page};
+
+    values = reallocate(values, values_size, new_values_capacity);
+    values_capacity = new_values_capacity;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::compact(size_type page) {
+    const size_type new_values_capacity {(values_size + page - 1) / page * page};
+
+    if (new_values_capacity == values_capacity || is_shared()) return;
+
+    if (new_values_capacity == 0) {
+        deallocate(values);
+        values = nullptr;
+    } else {
+        values = reallocate(values, values_size, new_values_capacity);
+    }
+
+    values_capacity = new_values_capacity;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::clear() {
+    if (is_shared()) {
+        // Leave shared values to the other buckets instead of copying them
+        deallocate(values);
+        values = nullptr;
+        values_capacity = 0;
+        values_size = 0;
+
+        return;
+    }
+
+    if constexpr (!trivial_values) {
+        // Release resources held by removed values
+        for (size_type i {0}; i < values_size; ++i) {
+            values[i] = value_type {};
+        }
+    }
+
+    values_size = 0;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+bool ADS_set<Key, N, Hash, Policy>::Bucket::is_shared() const {
+    if constexpr (shared_values) {
+        return values != nullptr && header_of(values)->references.load(std::memory_order_acquire) != 1;
+    } else {
+        return false;
+    }
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::unshare() {
+    if (!is_shared()) return;
+
+    value_type* own_values {allocate(values_capacity)};
+
+    if constexpr (trivial_values) {
+        std::memcpy(own_values, values, values_size * sizeof(value_type));
+    } else {
+        try {
+            for (size_type i {0}; i < values_size; ++i) {
+                own_values[i] = values[i];
+            }
+        } catch (...) {
+            deallocate(own_values);
+            throw;
+        }
+    }
+
+    deallocate(values);
+    values = own_values;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::share(const Bucket& other) {
+    if constexpr (shared_values) {
+        deallocate(values);
+
+        values_size = other.values_size;
+        values_capacity = other.values_capacity;
+        values = other.values;
+
+        if (values != nullptr) header_of(values)->references.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        *this = other;
+    }
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::attach(value_type* storage, size_type capacity) {
+    deallocate(values);
+
+    values_size = 0;
+    values_capacity = capacity;
+    values = storage;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::detach() {
+    values_size = 0;
+    values_capacity = 0;
+    values = nullptr;
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::swap_values(Bucket& other) {
+    using std::swap;
+
+    const size_type used {values_size > other.values_size ? values_size : other.values_size};
+
+    for (size_type i {0}; i < used; ++i) {
+        swap(values[i], other.values[i]);
+    }
+
+    swap(values_size, other.values_size);
+}
+
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::swap(Bucket& other) {
     using std::swap;
 
     swap(values_size, other.values_size);
@@ -796,45 +2460,47 @@ void ADS_set<Key, N>::Bucket::swap(Bucket& other) {
     swap(values, other.values);
 }
 
-template<typename Key, size_t N>
-void ADS_set<Key, N>::Bucket::dump(std::ostream& o) const {
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Bucket::dump(size_type page, std::ostream& o) const {
     o << "(size: " << std::setfill(' ') << std::setw(2) << values_size << ", ";
     o << "capacity: " << std::setfill(' ') << std::setw(2) << values_capacity << ") | ";
 
     for (size_type i {0}; i < values_size; ++i) {
-        if (i > 0 && i % N == 0) o << " -> | ";
-        o << values[i] << " ";
+        if (i > 0 && i % page == 0) o << " -> | ";
+        o << decode(values[i]) << " ";
     }
 }
 
-template<typename Key, size_t N>
-void ADS_set<Key, N>::Iterator::skip_empty_buckets() {
+template<typename Key, size_t N, typename Hash, typename Policy>
+void ADS_set<Key, N, Hash, Policy>::Iterator::skip_empty_buckets() {
     while (current != end && current->size() == 0) {
         ++current;
     }
 }
 
-template<typename Key, size_t N>
-ADS_set<Key, N>::Iterator::Iterator(bucket_pointer current, bucket_pointer end, bucket_size_type index) :
+template<typename Key, size_t N, typename Hash, typename Policy>
+ADS_set<Key, N, Hash, Policy>::Iterator::Iterator(bucket_pointer current, bucket_pointer end, bucket_size_type index) :
         current {current}, end {end}, index {index} {
-    if (index >= current->size()) {
+    // The end iterator does not reference a bucket
+    if (current != end && index >= current->size()) {
         this->index = 0;
         skip_empty_buckets();
     }
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::Iterator::reference ADS_set<Key, N>::Iterator::operator*() const {
-    return (*current)[index];
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::Iterator::reference ADS_set<Key, N, Hash, Policy>::Iterator::operator*() const {
+    return decode((*current)[index]);
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::Iterator::pointer ADS_set<Key, N>::Iterator::operator->() const {
-    return &(operator*());
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::Iterator::pointer ADS_set<Key, N, Hash, Policy>::Iterator::operator->() const {
+    if constexpr (stores_hash) return Arrow {operator*()};
+    else return &(operator*());
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::Iterator& ADS_set<Key, N>::Iterator::operator++() {
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::Iterator& ADS_set<Key, N, Hash, Policy>::Iterator::operator++() {
     // Do not advance when we reached the end bucket
     if (current == end) {
         return *this;
@@ -854,20 +2520,20 @@ typename ADS_set<Key, N>::Iterator& ADS_set<Key, N>::Iterator::operator++() {
     return *this;
 }
 
-template<typename Key, size_t N>
-typename ADS_set<Key, N>::Iterator ADS_set<Key, N>::Iterator::operator++(int) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+typename ADS_set<Key, N, Hash, Policy>::Iterator ADS_set<Key, N, Hash, Policy>::Iterator::operator++(int) {
     Iterator tmp {*this};
     ++*this;
     return tmp;
 }
 
-template<typename Key, size_t N>
-void swap(ADS_set<Key, N>& first, ADS_set<Key, N>& second) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+void swap(ADS_set<Key, N, Hash, Policy>& first, ADS_set<Key, N, Hash, Policy>& second) {
     first.swap(second);
 }
 
-template<typename Key, size_t N>
-void swap(typename ADS_set<Key, N>::Bucket& first, typename ADS_set<Key, N>::Bucket& second) {
+template<typename Key, size_t N, typename Hash, typename Policy>
+void swap(typename ADS_set<Key, N, Hash, Policy>::Bucket& first, typename ADS_set<Key, N, Hash, Policy>::Bucket& second) {
     first.swap(second);
 }
 
@@ -0,0 +1,169 @@
+#ifndef ADS_SHARDED_SET_H
+#define ADS_SHARDED_SET_H
+
+#include <mutex>
+#include <shared_mutex>
+
+#include "ADS_set.h"
+
+/**
+ * Thread-safe set that distributes keys over independently locked ADS_sets.
+ *
+ * Readers of a shard share its lock, writers hold it exclusively. Keys are
+ * assigned to shards by the high bits of their mixed hash, so the low bits
+ * stay uniformly distributed within each shard's linear hashing table. Each
+ * key is hashed once, the shard's set reuses the hash value.
+ *
+ * @tparam Key key type
+ * @tparam N size of the buckets of each shard
+ * @tparam Shards amount of shards, must be a power of two
+ * @tparam Hash hash function object type
+ */
+template<typename Key, size_t N = 5, size_t Shards = 16, typename Hash = std::hash<Key>>
+class ADS_sharded_set {
+    static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "Shards must be a power of two");
+
+public:
+    using set_type = ADS_set<Key, N, Hash>;
+    using value_type = typename set_type::value_type;
+    using key_type = typename set_type::key_type;
+    using size_type = typename set_type::size_type;
+    using hasher = typename set_type::hasher;
+private:
+    /** Amount of hash bits used to select a shard */
+    static constexpr unsigned shard_bits {[] {
+        unsigned bits {0};
+        while ((size_t {1} << bits) < Shards) ++bits;
+        return bits;
+    }()};
+
+    /** Shard padded to its own cache lines to avoid false sharing of locks */
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        set_type set;
+    };
+
+    /** Shards of the set */
+    Shard shards[Shards];
+
+    /** Hash instance */
+    const hasher hash {};
+
+    /**
+     * Get the shard responsible for keys of the given hash value.
+     *
+     * @param hash_value hash value of the key to probe for
+     * @return reference to shard
+     */
+    Shard& shard_of(size_type hash_value);
+
+    const Shard& shard_of(size_type hash_value) const;
+
+public:
+    ADS_sharded_set() = default;
+
+    ADS_sharded_set(const ADS_sharded_set&) = delete;
+
+    ADS_sharded_set& operator=(const ADS_sharded_set&) = delete;
+
+    /**
+     * Insert a given key.
+     *
+     * @param key the key to insert
+     * @return whether the key was newly added
+     */
+    bool insert(const key_type& key);
+
+    /**
+     * Removes the given key from the set.
+     *
+     * @param key the key to remove
+     * @return the amount of removed elements
+     */
+    size_type erase(const key_type& key);
+
+    /**
+     * Count how many times a key exists in the set (0 or 1).
+     *
+     * @param key the key to count for
+     * @return how many times the key exists (0 or 1)
+     */
+    size_type count(const key_type& key) const;
+
+    /**
+     * Clear all values of the set.
+     */
+    void clear();
+
+    /**
+     * Get the total amount of stored values. Shards are locked one after
+     * another, so the result is only exact without concurrent writers.
+     *
+     * @return total amount of stored values
+     */
+    [[nodiscard]] size_type size() const;
+};
+
+template<typename Key, size_t N, size_t Shards, typename Hash>
+typename ADS_sharded_set<Key, N, Shards, Hash>::Shard& ADS_sharded_set<Key, N, Shards, Hash>::shard_of(size_type hash_value) {
+    // Fibonacci hashing moves well mixed bits to the top
+    const auto mixed {static_cast<unsigned long long>(hash_value) * 0x9e3779b97f4a7c15ULL};
+
+    if constexpr (shard_bits == 0) return shards[0];
+    else return shards[mixed >> (64 - shard_bits)];
+}
+
+template<typename Key, size_t N, size_t Shards, typename Hash>
+const typename ADS_sharded_set<Key, N, Shards, Hash>::Shard&
+ADS_sharded_set<Key, N, Shards, Hash>::shard_of(size_type hash_value) const {
+    return const_cast<ADS_sharded_set*>(this)->shard_of(hash_value);
+}
+
+template<typename Key, size_t N, size_t Shards, typename Hash>
+bool ADS_sharded_set<Key, N, Shards, Hash>::insert(const key_type& key) {
+    const size_type hash_value {hash(key)};
+    Shard& shard {shard_of(hash_value)};
+    std::unique_lock lock {shard.mutex};
+
+    return shard.set.insert_hashed(key, hash_value).second;
+}
+
+template<typename Key, size_t N, size_t Shards, typename Hash>
+typename ADS_sharded_set<Key, N, Shards, Hash>::size_type ADS_sharded_set<Key, N, Shards, Hash>::erase(const key_type& key) {
+    const size_type hash_value {hash(key)};
+    Shard& shard {shard_of(hash_value)};
+    std::unique_lock lock {shard.mutex};
+
+    return shard.set.erase_hashed(key, hash_value);
+}
+
+template<typename Key, size_t N, size_t Shards, typename Hash>
+typename ADS_sharded_set<Key, N, Shards, Hash>::size_type ADS_sharded_set<Key, N, Shards, Hash>::count(const key_type& key) const {
+    const size_type hash_value {hash(key)};
+    const Shard& shard {shard_of(hash_value)};
+    std::shared_lock lock {shard.mutex};
+
+    return shard.set.count_hashed(key, hash_value);
+}
+
+template<typename Key, size_t N, size_t Shards, typename Hash>
+void ADS_sharded_set<Key, N, Shards, Hash>::clear() {
+    for (auto& shard: shards) {
+        std::unique_lock lock {shard.mutex};
+        shard.set.clear();
+    }
+}
+
+template<typename Key, size_t N, size_t Shards, typename Hash>
+typename ADS_sharded_set<Key, N, Shards, Hash>::size_type ADS_sharded_set<Key, N, Shards, Hash>::size() const {
+    size_type total {0};
+
+    for (const auto& shard: shards) {
+        std::shared_lock lock {shard.mutex};
+        total += shard.set.size();
+    }
+
+    return total;
+}
+
+#endif // ADS_SHARDED_SET_H
@@ -0,0 +1,107 @@
+#ifndef ADS_SIMD_H
+#define ADS_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Whether ADS_find_integer() compares values of the given type with vector
+ * instructions where the CPU supports them.
+ */
+template<typename Value>
+inline constexpr bool ADS_simd_searchable {
+    std::is_integral_v<Value> && !std::is_same_v<Value, bool> && (sizeof(Value) == 4 || sizeof(Value) == 8)
+};
+
+#if defined(__x86_64__)
+/**
+ * Whether the CPU supports AVX2, checked once on first use.
+ */
+inline bool ADS_has_avx2() {
+    static const bool supported {__builtin_cpu_supports("avx2") != 0};
+
+    return supported;
+}
+
+/**
+ * Find a 32 or 64 bit integer among the given values with AVX2, comparing 8
+ * or 4 values per instruction. Values are loaded through unaligned vector
+ * loads of the original array, and the last, partial vector from a copy, so
+ * no memory beyond size values is read. Requires a CPU with AVX2.
+ *
+ * @tparam Value integer type of 32 or 64 bits
+ * @param values array of values
+ * @param size amount of values
+ * @param key value to find
+ * @return index of the value; if it wasn't found size
+ */
+template<typename Value>
+__attribute__((target("avx2"))) std::size_t ADS_find_avx2(const Value* values, std::size_t size, Value key) {
+    constexpr std::size_t lanes {sizeof(__m256i) / sizeof(Value)};
+
+    __m256i needle;
+
+    if constexpr (sizeof(Value) == 4) needle = _mm256_set1_epi32(static_cast<int>(key));
+    else needle = _mm256_set1_epi64x(static_cast<long long>(key));
+
+    Value tail[lanes] {};
+
+    for (std::size_t i {0}; i < size; i += lanes) {
+        const Value* block_values {values + i};
+        unsigned valid {~0u};
+
+        if (size - i < lanes) {
+            // Compare a copy of the last, partial vector and ignore its zeroed lanes
+            std::memcpy(tail, values + i, (size - i) * sizeof(Value));
+            block_values = tail;
+            valid = (1u << ((size - i) * sizeof(Value))) - 1;
+        }
+
+        const __m256i block {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block_values))};
+        __m256i equal;
+
+        if constexpr (sizeof(Value) == 4) equal = _mm256_cmpeq_epi32(block, needle);
+        else equal = _mm256_cmpeq_epi64(block, needle);
+
+        // Each matching value sets sizeof(Value) bits of the byte mask
+        const unsigned matches {static_cast<unsigned>(_mm256_movemask_epi8(equal)) & valid};
+
+        if (matches != 0) return i + static_cast<std::size_t>(__builtin_ctz(matches)) / sizeof(Value);
+    }
+
+    return size;
+}
+#endif
+
+/**
+ * Find an integer among the given values. Uses AVX2 if the CPU supports it,
+ * checked once at runtime, and compares one value after another otherwise.
+ *
+ * @tparam Value integer type of 32 or 64 bits
+ * @param values array of values
+ * @param size amount of values
+ * @param key value to find
+ * @return index of the value; if it wasn't found size
+ */
+template<typename Value>
+std::size_t ADS_find_integer(const Value* values, std::size_t size, Value key) {
+    static_assert(ADS_simd_searchable<Value>, "Value must be a 32 or 64 bit integer");
+
+#if defined(__x86_64__)
+    if (ADS_has_avx2()) return ADS_find_avx2(values, size, key);
+#endif
+
+    for (std::size_t i {0}; i < size; ++i) {
+        if (values[i] == key) return i;
+    }
+
+    return size;
+}
+
+#endif // ADS_SIMD_H
@@ -0,0 +1,211 @@
+#ifndef ADS_STATIC_SET_H
+#define ADS_STATIC_SET_H
+
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "ADS_hash.h"
+
+/**
+ * Fixed-capacity set with Linear hashing addressing that can be built in
+ * constant expressions.
+ *
+ * A constexpr instance is computed by the compiler and placed in read-only
+ * data, so it costs neither startup time nor heap allocations. Buckets are
+ * addressed like ADS_set::bucket_at, with the split state chosen for the
+ * amount of keys so buckets hold N / 2 values on average. Values of each
+ * bucket are stored consecutively in one array, delimited by offsets.
+ *
+ * @tparam Key key type, must be a literal type
+ * @tparam Capacity maximum amount of keys
+ * @tparam N average size of the buckets times two
+ * @tparam Hash hash function object type, must be usable in constant expressions
+ */
+template<typename Key, size_t Capacity, size_t N = 5, typename Hash = ADS_constexpr_hash<Key>>
+class ADS_static_set {
+    static_assert(N > 0, "Buckets must hold at least one value");
+
+public:
+    using value_type = Key;
+    using key_type = Key;
+    using reference = const value_type&;
+    using const_reference = const value_type&;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_iterator = const value_type*;
+    using iterator = const_iterator;
+    using key_equal = std::equal_to<key_type>;
+    using hasher = Hash;
+private:
+    /** Maximum amount of buckets for Capacity keys */
+    static constexpr size_type max_table_size {2 * Capacity / N + 3};
+
+    /** Split round (d in lectures) */
+    size_type split_round {1};
+
+    /** Index of next bucket that would be split (nextToSplit in lectures) */
+    size_type table_split_index {0};
+
+    /** Number of stored values */
+    size_type table_items_size {0};
+
+    /** Index of the first value of each bucket, followed by the end of the last bucket */
+    size_type offsets[max_table_size + 1] {};
+
+    /** Values of all buckets */
+    value_type values[Capacity > 0 ? Capacity : 1] {};
+
+    /** Hash instance */
+    hasher hash {};
+
+    /** Get the index of the bucket for a hash value, see ADS_set::bucket_at */
+    constexpr size_type bucket_index(size_type hash_value) const {
+        size_type index {hash_value & ((size_type {1} << split_round) - 1)};
+
+        // Use next split round's hash function for already split buckets
+        if (index < table_split_index) {
+            index = hash_value & ((size_type {2} << split_round) - 1);
+        }
+
+        return index;
+    }
+
+public:
+    /**
+     * Creates an empty set.
+     */
+    constexpr ADS_static_set() : offsets {}, values {} {}
+
+    /**
+     * Creates a set with a given range of keys. Duplicate keys are stored once.
+     *
+     * @tparam ForwardIt type of forward iterator
+     * @param first first item in range
+     * @param last last item in range
+     * @throws std::length_error if the range holds more than Capacity keys
+     */
+    template<typename ForwardIt>
+    constexpr ADS_static_set(ForwardIt first, ForwardIt last);
+
+    /**
+     * Creates a set with a given list of keys. Duplicate keys are stored once.
+     *
+     * @param ilist list of keys to initialize with
+     * @throws std::length_error if the list holds more than Capacity keys
+     */
+    constexpr ADS_static_set(std::initializer_list<key_type> ilist) : ADS_static_set {ilist.begin(), ilist.end()} {}
+
+    /**
+     * Count how many times a key exists in the set (0 or 1).
+     *
+     * @param key the key to count for
+     * @return how many times the key exists (0 or 1)
+     */
+    constexpr size_type count(const key_type& key) const { return find(key) != end(); }
+
+    /**
+     * Finds the given key's value in the set.
+     *
+     * @param key the key to find
+     * @return iterator of found value; if nothing was found the end iterator
+     */
+    constexpr iterator find(const key_type& key) const;
+
+    constexpr const_iterator begin() const { return values; }
+
+    constexpr const_iterator end() const { return values + table_items_size; }
+
+    [[nodiscard]] constexpr size_type size() const { return table_items_size; };
+
+    [[nodiscard]] constexpr bool empty() const { return table_items_size == 0; };
+
+    [[nodiscard]] constexpr size_type bucket_count() const { return (size_type {1} << split_round) + table_split_index; };
+
+    [[nodiscard]] constexpr size_type bucket_size(size_type index) const { return offsets[index + 1] - offsets[index]; };
+};
+
+template<typename Key, size_t Capacity, size_t N, typename Hash>
+template<typename ForwardIt>
+constexpr ADS_static_set<Key, Capacity, N, Hash>::ADS_static_set(ForwardIt first, ForwardIt last) : offsets {}, values {} {
+    size_type keys {0};
+
+    for (auto it {first}; it != last; ++it) ++keys;
+
+    if (keys > Capacity) throw std::length_error {"more keys than the capacity of the set"};
+
+    // Choose the split state for N / 2 values per bucket, but at least two buckets
+    size_type buckets {(2 * keys + N - 1) / N};
+    if (buckets < 2) buckets = 2;
+
+    while ((size_type {2} << split_round) <= buckets) ++split_round;
+    table_split_index = buckets - (size_type {1} << split_round);
+
+    // Count values per bucket and turn the counts into offsets
+    for (auto it {first}; it != last; ++it) {
+        ++offsets[bucket_index(hash(*it)) + 1];
+    }
+
+    for (size_type i {0}; i < buckets; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    // Place values into their buckets
+    size_type cursors[max_table_size] {};
+
+    for (auto it {first}; it != last; ++it) {
+        const size_type index {bucket_index(hash(*it))};
+        values[offsets[index] + cursors[index]++] = *it;
+    }
+
+    // Drop duplicates, moving buckets down to close the gaps
+    size_type write {0};
+
+    for (size_type i {0}; i < buckets; ++i) {
+        const size_type bucket_begin {offsets[i]};
+        const size_type bucket_end {offsets[i + 1]};
+
+        offsets[i] = write;
+
+        for (size_type j {bucket_begin}; j < bucket_end; ++j) {
+            bool duplicate {false};
+
+            for (size_type k {offsets[i]}; k < write && !duplicate; ++k) {
+                duplicate = key_equal {}(values[k], values[j]);
+            }
+
+            if (!duplicate) values[write++] = values[j];
+        }
+    }
+
+    offsets[buckets] = write;
+    table_items_size = write;
+}
+
+template<typename Key, size_t Capacity, size_t N, typename Hash>
+constexpr typename ADS_static_set<Key, Capacity, N, Hash>::iterator
+ADS_static_set<Key, Capacity, N, Hash>::find(const key_type& key) const {
+    const size_type index {bucket_index(hash(key))};
+
+    for (size_type i {offsets[index]}; i < offsets[index + 1]; ++i) {
+        if (key_equal {}(values[i], key)) return values + i;
+    }
+
+    return end();
+}
+
+/**
+ * Creates a static set from an array of keys, with the capacity deduced.
+ *
+ * @tparam N average size of the buckets times two
+ * @tparam Key key type
+ * @tparam K amount of keys
+ * @param keys keys to initialize with
+ * @return set of the keys
+ */
+template<size_t N = 5, typename Key, size_t K>
+constexpr ADS_static_set<Key, K, N> ADS_make_static_set(const Key (&keys)[K]) {
+    return ADS_static_set<Key, K, N> {keys, keys + K};
+}
+
+#endif // ADS_STATIC_SET_H
@@ -0,0 +1,183 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <pthread.h>
+#include <random>
+#include <sched.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ADS_sharded_set.h"
+#include "perf_counters.h"
+
+/**
+ * Multi-threaded scaling benchmark for ADS_sharded_set.
+ *
+ * Every workload runs with 1..T threads, each pinned to its own CPU and
+ * performing a fixed amount of operations on a shared, prefilled set. The
+ * report lists total and per-thread throughput and the scaling efficiency
+ * relative to the single-threaded run.
+ *
+ * Passing --perf additionally reads hardware performance counters of all
+ * worker threads around each run and prints them per operation.
+ *
+ * Usage:
+ *   btest [--perf] [max_threads] [ops_per_thread]
+ */
+
+using key_type = std::uint64_t;
+using set_type = ADS_sharded_set<key_type>;
+using clock_type = std::chrono::steady_clock;
+
+/** Amount of distinct keys the workloads draw from */
+constexpr key_type key_universe {1u << 20};
+
+struct Workload {
+    const char* name;
+
+    /** Percentage of inserts */
+    unsigned insert_percent;
+
+    /** Percentage of erases, the remaining operations are lookups */
+    unsigned erase_percent;
+};
+
+constexpr Workload workloads[] {
+        {"read-heavy", 5, 5},
+        {"mixed", 25, 25},
+        {"write-heavy", 45, 45},
+};
+
+/** Receives the workloads' results, so they cannot be optimized away */
+volatile std::size_t sink {0};
+
+/**
+ * Pin the calling thread to the given CPU, wrapping around the available ones.
+ *
+ * @return whether the thread could be pinned
+ */
+bool pin_to_cpu(unsigned index) {
+    const unsigned cpus {std::max(1u, std::thread::hardware_concurrency())};
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    CPU_SET(index % cpus, &set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+/**
+ * Run the given workload with the given amount of threads.
+ *
+ * @param counters counters to read around the run, may be nullptr
+ * @return total throughput in operations per second
+ */
+double run(const Workload& workload, unsigned threads, std::size_t ops_per_thread, Perf_counters* counters) {
+    set_type set;
+
+    // Prefill half of the key universe so lookups and erases hit
+    for (key_type key {0}; key < key_universe; key += 2) {
+        set.insert(key);
+    }
+
+    std::atomic<unsigned> ready {0};
+    std::atomic<bool> go {false};
+    std::atomic<std::size_t> checksum {0};
+    std::vector<std::thread> pool;
+
+    for (unsigned t {0}; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            pin_to_cpu(t);
+
+            std::mt19937_64 engine {t + 1};
+            std::uniform_int_distribution<key_type> keys {0, key_universe - 1};
+            std::uniform_int_distribution<unsigned> percent {0, 99};
+            std::size_t local {0};
+
+            ++ready;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+            for (std::size_t i {0}; i < ops_per_thread; ++i) {
+                const key_type key {keys(engine)};
+                const unsigned p {percent(engine)};
+
+                if (p < workload.insert_percent) local += set.insert(key);
+                else if (p < workload.insert_percent + workload.erase_percent) local += set.erase(key);
+                else local += set.count(key);
+            }
+
+            checksum += local;
+        });
+    }
+
+    while (ready.load() != threads) std::this_thread::yield();
+
+    if (counters) counters->start();
+
+    const auto start {clock_type::now()};
+    go.store(true, std::memory_order_release);
+
+    for (auto& thread: pool) thread.join();
+
+    const auto stop {clock_type::now()};
+
+    if (counters) counters->stop();
+
+    const double seconds {std::chrono::duration<double>(stop - start).count()};
+
+    sink = checksum.load();
+
+    return static_cast<double>(ops_per_thread) * threads / seconds;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    Perf_counters* counters {nullptr};
+    Perf_counters perf;
+
+    if (!args.empty() && args[0] == "--perf") {
+        args.erase(args.begin());
+
+        if (perf.available()) counters = &perf;
+        else std::cerr << "warning: hardware performance counters are unavailable\n";
+    }
+
+    const unsigned max_threads {args.size() > 0 ? static_cast<unsigned>(std::stoul(args[0]))
+                                                : std::max(1u, std::thread::hardware_concurrency())};
+    const std::size_t ops_per_thread {args.size() > 1 ? std::stoull(args[1]) : 1'000'000};
+
+    if (!pin_to_cpu(0)) {
+        std::cerr << "warning: threads could not be pinned\n";
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+
+    for (const auto& workload: workloads) {
+        double single {0};
+
+        std::cout << workload.name << " (" << workload.insert_percent << "% insert, ";
+        std::cout << workload.erase_percent << "% erase)\n";
+
+        for (unsigned threads {1}; threads <= max_threads; ++threads) {
+            const double throughput {run(workload, threads, ops_per_thread, counters)};
+
+            if (threads == 1) single = throughput;
+
+            std::cout << "  threads " << std::setw(3) << threads;
+            std::cout << " | " << std::setw(8) << throughput / 1e6 << " Mops/s";
+            std::cout << " | " << std::setw(8) << throughput / threads / 1e6 << " Mops/s/thread";
+            std::cout << " | efficiency " << std::setw(6) << 100 * throughput / (threads * single) << "%\n";
+
+            if (counters) {
+                std::cout << "             ";
+                counters->print(ops_per_thread * threads);
+                std::cout << "\n";
+            }
+        }
+    }
+
+    return 0;
+}
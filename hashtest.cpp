@@ -0,0 +1,72 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ADS_hash_analyzer.h"
+
+/**
+ * Hash quality check over a sample of keys, one key per line.
+ *
+ * Analyzes the default hash and ADS_mix_hash on the sample and exits with
+ * status 2 if the default hash is weak in its low bits, so it can run as a
+ * CI step over production key samples.
+ *
+ * Usage:
+ *   hashtest [--unsigned] [file]
+ */
+
+template<typename Key>
+int analyze(const std::vector<Key>& keys) {
+    const auto report {ADS_analyze_hash<Key>(keys.begin(), keys.end())};
+
+    std::cout << "std::hash\n=========\n\n";
+    report.print(std::cout);
+
+    if (report.recommend_mixing) {
+        std::cout << "\nADS_mix_hash\n============\n\n";
+        ADS_analyze_hash<Key, 5, ADS_mix_hash<Key>>(keys.begin(), keys.end()).print(std::cout);
+    }
+
+    return report.recommend_mixing ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+    bool unsigned_keys {false};
+    std::string path;
+
+    for (int i {1}; i < argc; ++i) {
+        const std::string arg {argv[i]};
+
+        if (arg == "--unsigned") unsigned_keys = true;
+        else path = arg;
+    }
+
+    std::ifstream file;
+    if (!path.empty()) {
+        file.open(path);
+
+        if (!file) {
+            std::cerr << "could not open " << path << "\n";
+            return 1;
+        }
+    }
+
+    std::istream& in {path.empty() ? std::cin : file};
+    std::vector<std::string> lines;
+
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(line);
+    }
+
+    if (!unsigned_keys) return analyze(lines);
+
+    std::vector<unsigned long> keys;
+    keys.reserve(lines.size());
+
+    for (const auto& line: lines) {
+        keys.push_back(std::stoul(line));
+    }
+
+    return analyze(keys);
+}
@@ -0,0 +1,175 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * Hardware performance counters of the calling thread (and the threads it
+ * spawns while counting), read via Linux perf_event_open.
+ *
+ * Every counter is opened on its own, so unsupported events (e.g. in virtual
+ * machines or with a restrictive perf_event_paranoid) are reported as
+ * unavailable while the others keep working. Counts are scaled when the
+ * kernel had to multiplex the counters.
+ */
+class Perf_counters {
+public:
+    enum Event {
+        cycles,
+        instructions,
+        l1d_misses,
+        llc_misses,
+        dtlb_misses,
+        branch_misses,
+        event_count
+    };
+
+private:
+    struct Counter {
+        const char* name;
+        std::uint32_t type;
+        std::uint64_t config;
+        int fd;
+        std::uint64_t value;
+        bool valid;
+    };
+
+    static constexpr std::uint64_t cache_event(std::uint64_t cache, std::uint64_t op, std::uint64_t result) {
+        return cache | (op << 8) | (result << 16);
+    }
+
+    Counter counters[event_count] {
+            {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1, 0, false},
+            {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, -1, 0, false},
+            {"L1d-misses", PERF_TYPE_HW_CACHE,
+             cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS), -1, 0, false},
+            {"LLC-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, -1, 0, false},
+            {"dTLB-misses", PERF_TYPE_HW_CACHE,
+             cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS), -1, 0, false},
+            {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, -1, 0, false},
+    };
+
+public:
+    /**
+     * Open all counters, disabled until start() is called.
+     */
+    Perf_counters() {
+        for (auto& counter: counters) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+
+            attr.size = sizeof(attr);
+            attr.type = counter.type;
+            attr.config = counter.config;
+            attr.disabled = 1;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            counter.fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+    }
+
+    ~Perf_counters() {
+        for (auto& counter: counters) {
+            if (counter.fd >= 0) close(counter.fd);
+        }
+    }
+
+    Perf_counters(const Perf_counters&) = delete;
+
+    Perf_counters& operator=(const Perf_counters&) = delete;
+
+    /**
+     * Get whether at least one counter could be opened.
+     */
+    [[nodiscard]] bool available() const {
+        for (const auto& counter: counters) {
+            if (counter.fd >= 0) return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Reset and enable all counters.
+     */
+    void start() {
+        for (auto& counter: counters) {
+            if (counter.fd < 0) continue;
+
+            ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    /**
+     * Disable all counters and read their values.
+     */
+    void stop() {
+        for (auto& counter: counters) {
+            counter.valid = false;
+
+            if (counter.fd < 0) continue;
+
+            ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+
+            // value, time enabled, time running
+            std::uint64_t data[3];
+
+            if (read(counter.fd, data, sizeof(data)) != sizeof(data) || data[2] == 0) continue;
+
+            counter.value = data[2] < data[1]
+                            ? static_cast<std::uint64_t>(static_cast<double>(data[0]) * data[1] / data[2])
+                            : data[0];
+            counter.valid = true;
+        }
+    }
+
+    /**
+     * Get whether the given event was counted in the last start()/stop() phase.
+     */
+    [[nodiscard]] bool valid(Event event) const { return counters[event].valid; }
+
+    /**
+     * Get the value of the given event of the last start()/stop() phase.
+     */
+    [[nodiscard]] std::uint64_t value(Event event) const { return counters[event].value; }
+
+    /**
+     * Print the counters of the last phase per operation.
+     *
+     * @param ops amount of operations performed in the phase
+     * @param o the stream to print to
+     */
+    void print(std::size_t ops, std::ostream& o = std::cout) const {
+        const double n {static_cast<double>(ops == 0 ? 1 : ops)};
+
+        o << std::fixed << std::setprecision(2);
+
+        for (const auto& counter: counters) {
+            o << " " << counter.name << "/op ";
+
+            if (counter.valid) o << static_cast<double>(counter.value) / n;
+            else o << "n/a";
+        }
+
+        o << " IPC ";
+
+        if (valid(cycles) && valid(instructions) && value(cycles) > 0) {
+            o << static_cast<double>(value(instructions)) / static_cast<double>(value(cycles));
+        } else {
+            o << "n/a";
+        }
+    }
+};
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,1284 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <malloc.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ADS_compact_set.h"
+#include "ADS_hash.h"
+#include "ADS_set.h"
+#include "perf_counters.h"
+
+/**
+ * Workload replay benchmark for ADS_set.
+ *
+ * Operations are described by traces, which are either generated in memory
+ * or read from a binary trace file. A trace file starts with a header
+ * (magic "ADSTRACE", uint32 version, uint64 record count) followed by packed
+ * 9 byte records (uint8 operation, uint64 key), all little-endian.
+ *
+ * Passing --perf additionally reads hardware performance counters around
+ * the throughput replay and prints them per operation.
+ *
+ * Usage:
+ *   perftest [--perf]                        run all distributions
+ *   perftest run <dist> [ops] [seed]         run one distribution
+ *   perftest gen <dist> <ops> <file> [seed]  write a trace file
+ *   perftest replay <file>                   replay a trace file
+ *   perftest paths [keys]                    time the split, copy and lookup paths
+ *   perftest probes [keys]                   compare probe lengths of the growth modes
+ *   perftest pages [keys]                    sweep the bucket size chosen at runtime
+ *   perftest choices [keys]                  compare bucket occupancy with one and two choices
+ *   perftest hot [keys]                      time Zipfian lookups with and without promoting hits
+ *   perftest sorted [keys]                   compare scanned and sorted buckets for large N
+ *   perftest strings [keys]                  compare string hashes across key lengths
+ *
+ * Distributions: uniform, zipf, sequential, lowbit
+ */
+
+using key_type = std::uint64_t;
+using set_type = ADS_set<key_type>;
+using clock_type = std::chrono::steady_clock;
+
+enum class Operation : std::uint8_t {
+    insert = 0,
+    erase = 1,
+    find = 2,
+};
+
+struct Record {
+    Operation op;
+    key_type key;
+};
+
+using Trace = std::vector<Record>;
+
+constexpr char trace_magic[8] {'A', 'D', 'S', 'T', 'R', 'A', 'C', 'E'};
+constexpr std::uint32_t trace_version {1};
+constexpr std::size_t record_bytes {1 + sizeof(key_type)};
+
+/** Percentage of operations per kind in generated traces */
+constexpr unsigned insert_percent {40};
+constexpr unsigned erase_percent {10};
+
+/** Amount of ops between two heap usage samples */
+constexpr std::size_t memory_sample_interval {1024};
+
+/**
+ * Draws keys following Zipf's law over a fixed universe of keys.
+ */
+class Zipf_distribution {
+    std::vector<double> cdf;
+
+public:
+    Zipf_distribution(std::size_t universe, double exponent) : cdf(universe) {
+        double sum {0};
+
+        for (std::size_t i {0}; i < universe; ++i) {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+            cdf[i] = sum;
+        }
+
+        for (auto& value: cdf) value /= sum;
+    }
+
+    template<typename Engine>
+    std::size_t operator()(Engine& engine) {
+        const double u {std::uniform_real_distribution<double> {0.0, 1.0}(engine)};
+
+        return static_cast<std::size_t>(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+    }
+};
+
+/**
+ * Generates a trace with the given key distribution.
+ *
+ * Inserts, erases and finds are mixed by insert_percent and erase_percent.
+ * Erases and finds draw from the same distribution as inserts, so they hit
+ * previously inserted keys with the distribution's own probability.
+ *
+ * @param dist name of the key distribution
+ * @param ops amount of operations
+ * @param seed seed of the random engine
+ * @param trace trace to fill
+ * @return whether dist names a known distribution
+ */
+bool generate(const std::string& dist, std::size_t ops, std::uint64_t seed, Trace& trace) {
+    std::mt19937_64 engine {seed};
+    std::uniform_int_distribution<unsigned> percent {0, 99};
+
+    // Keep the live key set around a quarter of the trace length
+    const std::size_t universe {std::max<std::size_t>(ops / 4, 1)};
+    std::uniform_int_distribution<std::size_t> uniform {0, universe - 1};
+    Zipf_distribution zipf {dist == "zipf" ? universe : 1, 0.99};
+    std::size_t sequence {0};
+
+    auto next_key = [&]() -> key_type {
+        if (dist == "uniform") return ADS_mix64(uniform(engine));
+        if (dist == "zipf") return ADS_mix64(zipf(engine));
+        if (dist == "sequential") return sequence++ % universe;
+
+        // Every key shares the same 20 low bits
+        return static_cast<key_type>(uniform(engine)) << 20;
+    };
+
+    if (dist != "uniform" && dist != "zipf" && dist != "sequential" && dist != "lowbit") return false;
+
+    trace.clear();
+    trace.reserve(ops);
+
+    for (std::size_t i {0}; i < ops; ++i) {
+        const unsigned p {percent(engine)};
+        Operation op {Operation::find};
+
+        if (p < insert_percent) op = Operation::insert;
+        else if (p < insert_percent + erase_percent) op = Operation::erase;
+
+        trace.push_back({op, next_key()});
+    }
+
+    return true;
+}
+
+void write_le(std::ostream& o, std::uint64_t value, std::size_t bytes) {
+    for (std::size_t i {0}; i < bytes; ++i) {
+        o.put(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+std::uint64_t read_le(const unsigned char* data, std::size_t bytes) {
+    std::uint64_t value {0};
+
+    for (std::size_t i {0}; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+    }
+
+    return value;
+}
+
+bool write_trace(const std::string& path, const Trace& trace) {
+    std::ofstream o {path, std::ios::binary};
+
+    o.write(trace_magic, sizeof(trace_magic));
+    write_le(o, trace_version, sizeof(trace_version));
+    write_le(o, trace.size(), sizeof(std::uint64_t));
+
+    for (const auto& record: trace) {
+        o.put(static_cast<char>(record.op));
+        write_le(o, record.key, sizeof(key_type));
+    }
+
+    return static_cast<bool>(o);
+}
+
+bool read_trace(const std::string& path, Trace& trace) {
+    std::ifstream i {path, std::ios::binary};
+    unsigned char header[sizeof(trace_magic) + sizeof(std::uint32_t) + sizeof(std::uint64_t)];
+
+    if (!i.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+    if (std::memcmp(header, trace_magic, sizeof(trace_magic)) != 0) return false;
+    if (read_le(header + sizeof(trace_magic), sizeof(std::uint32_t)) != trace_version) return false;
+
+    const std::uint64_t count {read_le(header + sizeof(trace_magic) + sizeof(std::uint32_t), sizeof(std::uint64_t))};
+    unsigned char record[record_bytes];
+
+    trace.clear();
+    trace.reserve(count);
+
+    for (std::uint64_t n {0}; n < count; ++n) {
+        if (!i.read(reinterpret_cast<char*>(record), sizeof(record))) return false;
+        if (record[0] > static_cast<unsigned char>(Operation::find)) return false;
+
+        trace.push_back({static_cast<Operation>(record[0]), read_le(record + 1, sizeof(key_type))});
+    }
+
+    return true;
+}
+
+/**
+ * Get the amount of heap memory in use according to the allocator.
+ */
+std::size_t heap_in_use() {
+    const auto info {mallinfo2()};
+
+    return info.uordblks + info.hblkhd;
+}
+
+/**
+ * Apply a single record to the set.
+ *
+ * @return value folded into the checksum, to keep results observable
+ */
+inline std::size_t apply(set_type& set, const Record& record) {
+    switch (record.op) {
+        case Operation::insert:
+            return set.insert(record.key).second;
+        case Operation::erase:
+            return set.erase(record.key);
+        case Operation::find:
+            return set.find(record.key) != set.end();
+    }
+
+    return 0;
+}
+
+struct Result {
+    double seconds {0};
+    std::size_t checksum {0};
+    std::size_t size {0};
+    std::size_t buckets {0};
+    std::size_t splits {0};
+    std::size_t peak_bytes {0};
+    std::vector<std::uint64_t> latencies;
+};
+
+/**
+ * Replay the trace twice on fresh sets: once timed as a whole for throughput
+ * and heap usage, once timing every single operation for the latency
+ * distribution.
+ *
+ * @param trace trace to replay
+ * @param counters counters to read around the throughput replay, may be nullptr
+ */
+Result replay(const Trace& trace, Perf_counters* counters) {
+    Result result;
+
+    {
+        const std::size_t heap_before {heap_in_use()};
+        set_type set;
+        std::size_t checksum {0};
+        std::size_t peak {0};
+
+        if (counters) counters->start();
+
+        const auto start {clock_type::now()};
+
+        for (std::size_t i {0}; i < trace.size(); ++i) {
+            checksum += apply(set, trace[i]);
+
+            if (i % memory_sample_interval == 0) {
+                peak = std::max(peak, heap_in_use());
+            }
+        }
+
+        const auto stop {clock_type::now()};
+
+        if (counters) counters->stop();
+
+        peak = std::max(peak, heap_in_use());
+
+        result.seconds = std::chrono::duration<double>(stop - start).count();
+        result.checksum = checksum;
+        result.size = set.size();
+        result.buckets = set.bucket_count();
+        result.splits = set.split_count();
+        result.peak_bytes = peak > heap_before ? peak - heap_before : 0;
+    }
+
+    {
+        set_type set;
+        std::size_t checksum {0};
+
+        result.latencies.reserve(trace.size());
+
+        for (const auto& record: trace) {
+            const auto start {clock_type::now()};
+            checksum += apply(set, record);
+            const auto stop {clock_type::now()};
+
+            result.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+        }
+
+        if (checksum != result.checksum) {
+            std::cerr << "checksum mismatch between replays\n";
+        }
+    }
+
+    return result;
+}
+
+std::uint64_t percentile(const std::vector<std::uint64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+
+    const auto index {static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1))};
+
+    return sorted[index];
+}
+
+void report(const std::string& name, const Trace& trace, Perf_counters* counters) {
+    Result result {replay(trace, counters)};
+    std::sort(result.latencies.begin(), result.latencies.end());
+
+    const double mops {static_cast<double>(trace.size()) / result.seconds / 1e6};
+
+    std::cout << std::left << std::setw(12) << name << std::right;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << " ops " << std::setw(9) << trace.size();
+    std::cout << " | " << std::setw(7) << mops << " Mops/s";
+    std::cout << " | ns p50 " << std::setw(5) << percentile(result.latencies, 0.50);
+    std::cout << " p90 " << std::setw(5) << percentile(result.latencies, 0.90);
+    std::cout << " p99 " << std::setw(6) << percentile(result.latencies, 0.99);
+    std::cout << " p99.9 " << std::setw(7) << percentile(result.latencies, 0.999);
+    std::cout << " max " << std::setw(8) << percentile(result.latencies, 1.0);
+    std::cout << " | size " << std::setw(8) << result.size;
+    std::cout << " buckets " << std::setw(8) << result.buckets;
+    std::cout << " splits " << std::setw(8) << result.splits;
+    std::cout << " | peak " << std::setw(8) << std::setprecision(1) << result.peak_bytes / 1024.0 << " KiB";
+    std::cout << " | checksum " << result.checksum << "\n";
+
+    if (counters) {
+        std::cout << std::setw(12) << "";
+        counters->print(trace.size());
+        std::cout << "\n";
+    }
+}
+
+/**
+ * Key with the layout of key_type that is not trivially copyable, to compare
+ * the generic bucket code paths with the ones for trivially copyable keys.
+ */
+struct Boxed_key {
+    key_type value {0};
+
+    Boxed_key() = default;
+
+    Boxed_key(key_type value) : value {value} {}
+
+    Boxed_key(const Boxed_key& other) : value {other.value} {}
+
+    Boxed_key& operator=(const Boxed_key& other) {
+        value = other.value;
+        return *this;
+    }
+
+    friend bool operator==(const Boxed_key& lhs, const Boxed_key& rhs) { return lhs.value == rhs.value; }
+
+    friend std::ostream& operator<<(std::ostream& o, const Boxed_key& key) { return o << key.value; }
+};
+
+struct Boxed_hash {
+    std::size_t operator()(const Boxed_key& key) const { return std::hash<key_type> {}(key.value); }
+};
+
+/**
+ * Policy enabling the membership filter of ADS_set.
+ */
+struct Filtered_policy : ADS_default_policy {
+    static constexpr std::size_t filter_bits {8};
+};
+
+/**
+ * Policy enabling snapshots of ADS_set.
+ */
+struct Snapshot_policy : ADS_default_policy {
+    static constexpr bool snapshots {true};
+};
+
+/**
+ * Policy splitting ahead once a bucket holds more than 20 values.
+ */
+struct Chain_policy : ADS_default_policy {
+    static constexpr std::size_t chain_limit {20};
+};
+
+/**
+ * Policy growing the table by partial expansions.
+ */
+struct Partial_policy : ADS_default_policy {
+    static constexpr bool partial_expansions {true};
+};
+
+/**
+ * Policy seeding the hash and reseeding once a bucket holds more than 20 values.
+ */
+struct Reseed_policy : ADS_default_policy {
+    static constexpr std::size_t reseed_limit {20};
+};
+
+/**
+ * Policy inserting keys into the less loaded of two buckets.
+ */
+struct Two_choice_policy : ADS_default_policy {
+    static constexpr bool two_choice {true};
+};
+
+/**
+ * Policy moving found values towards the front of their bucket.
+ */
+struct Promote_policy : ADS_default_policy {
+    static constexpr bool promote_hits {true};
+};
+
+/**
+ * Policy keeping the values of each bucket ordered by hash value.
+ */
+struct Sorted_policy : ADS_default_policy {
+    static constexpr bool sorted_buckets {true};
+};
+
+/**
+ * Policy storing up to 16 values within the set object.
+ */
+struct Inline_policy : ADS_default_policy {
+    static constexpr std::size_t inline_values {16};
+};
+
+/**
+ * Time filling a set (dominated by bucket splits and overflow growth),
+ * copying it and looking up every key and as many absent keys.
+ *
+ * @tparam Set set type to measure
+ * @param name name printed for the set type
+ * @param keys amount of keys to insert
+ * @param empty empty set to start from, carrying its configuration
+ */
+template<typename Set>
+void bench_paths(const std::string& name, std::size_t keys, const Set& empty = Set {}) {
+    const auto ns_per_key = [keys](clock_type::time_point start, clock_type::time_point stop) {
+        return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(keys);
+    };
+
+    const auto fill_start {clock_type::now()};
+    Set set {empty};
+
+    // Keys start at 1, as 0 is the sentinel of compact sets
+    for (std::size_t i {1}; i <= keys; ++i) {
+        set.insert(static_cast<key_type>(ADS_mix64(i)));
+    }
+
+    const auto fill_stop {clock_type::now()};
+    const Set copy {set};
+    const auto copy_stop {clock_type::now()};
+    std::size_t found {0};
+
+    for (std::size_t i {1}; i <= keys; ++i) {
+        found += set.count(static_cast<key_type>(ADS_mix64(i)));
+    }
+
+    const auto find_stop {clock_type::now()};
+
+    // Absent keys, disjoint from the stored ones as ADS_mix64 is bijective
+    for (std::size_t i {keys + 1}; i <= 2 * keys; ++i) {
+        found += set.count(static_cast<key_type>(ADS_mix64(i)));
+    }
+
+    const auto miss_stop {clock_type::now()};
+
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2);
+    std::cout << " keys " << std::setw(9) << keys;
+    std::cout << " | fill " << std::setw(7) << ns_per_key(fill_start, fill_stop) << " ns/key";
+    std::cout << " | copy " << std::setw(7) << ns_per_key(fill_stop, copy_stop) << " ns/key";
+    std::cout << " | find " << std::setw(7) << ns_per_key(copy_stop, find_stop) << " ns/key";
+    std::cout << " | miss " << std::setw(7) << ns_per_key(find_stop, miss_stop) << " ns/key";
+    std::cout << " | splits " << set.split_count();
+    std::cout << (copy == set && found == keys ? "" : " | contents differ") << "\n";
+}
+
+/**
+ * Time creating, filling and destroying many sets of few keys.
+ *
+ * @tparam Set set type to measure
+ * @param name name of the variant
+ * @param keys total amount of keys
+ * @param per_set amount of keys per set
+ */
+template<typename Set>
+void bench_small_sets(const std::string& name, std::size_t keys, std::size_t per_set) {
+    const auto start {clock_type::now()};
+    std::size_t found {0};
+
+    for (std::size_t first {1}; first + per_set <= keys + 1; first += per_set) {
+        Set set;
+
+        for (std::size_t i {first}; i < first + per_set; ++i) {
+            set.insert(static_cast<key_type>(ADS_mix64(i)));
+        }
+
+        Set moved {std::move(set)};
+        found += moved.count(static_cast<key_type>(ADS_mix64(first)));
+    }
+
+    const auto stop {clock_type::now()};
+
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2);
+    std::cout << " keys " << std::setw(9) << keys;
+    std::cout << " | sets of " << per_set << " " << std::setw(7);
+    std::cout << std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(keys) << " ns/key";
+    std::cout << (found == keys / per_set ? "" : " | contents differ") << "\n";
+}
+
+/**
+ * Time refilling one set in batches, emptying it by clear() or release() in between.
+ *
+ * @param keys total amount of keys
+ * @param batches amount of batches
+ * @param release whether release() is used instead of clear()
+ */
+void bench_batches(std::size_t keys, std::size_t batches, bool release) {
+    const std::size_t per_batch {keys / batches};
+    ADS_set<key_type> set;
+    std::size_t found {0};
+    const auto start {clock_type::now()};
+
+    for (std::size_t batch {0}; batch < batches; ++batch) {
+        for (std::size_t i {1}; i <= per_batch; ++i) {
+            set.insert(static_cast<key_type>(ADS_mix64(batch * per_batch + i)));
+        }
+
+        found += set.count(static_cast<key_type>(ADS_mix64(batch * per_batch + 1)));
+
+        if (release) set.release();
+        else set.clear();
+    }
+
+    const auto stop {clock_type::now()};
+
+    std::cout << std::left << std::setw(28) << (release ? "batches with release()" : "batches with clear()");
+    std::cout << std::right << std::fixed << std::setprecision(2);
+    std::cout << " keys " << std::setw(9) << per_batch * batches;
+    std::cout << " | batches of " << per_batch << " " << std::setw(7);
+    std::cout << std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(per_batch * batches) << " ns/key";
+    std::cout << (found == batches ? "" : " | contents differ") << "\n";
+}
+
+/**
+ * Time taking a snapshot of a set, compared with a full copy, and the
+ * cost of modifying the set afterwards while the snapshot shares its buckets.
+ *
+ * @param keys amount of keys
+ */
+void bench_snapshot(std::size_t keys) {
+    const auto ns_per_key = [keys](clock_type::time_point start, clock_type::time_point stop) {
+        return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(keys);
+    };
+
+    ADS_set<key_type, 5, std::hash<key_type>, Snapshot_policy> set;
+
+    for (std::size_t i {1}; i <= keys; ++i) {
+        set.insert(static_cast<key_type>(ADS_mix64(i)));
+    }
+
+    const auto copy_start {clock_type::now()};
+    const auto copy {set};
+    const auto copy_stop {clock_type::now()};
+    const auto snapshot {set.snapshot()};
+    const auto snapshot_stop {clock_type::now()};
+
+    // Replace a tenth of the keys, each first modification copies a bucket
+    for (std::size_t i {1}; i <= keys / 10; ++i) {
+        set.erase(static_cast<key_type>(ADS_mix64(i)));
+        set.insert(static_cast<key_type>(ADS_mix64(keys + i)));
+    }
+
+    const auto churn_stop {clock_type::now()};
+
+    std::cout << std::left << std::setw(28) << "snapshots" << std::right << std::fixed << std::setprecision(2);
+    std::cout << " keys " << std::setw(9) << keys;
+    std::cout << " | copy " << std::setw(7) << ns_per_key(copy_start, copy_stop) << " ns/key";
+    std::cout << " | snapshot " << std::setw(7) << ns_per_key(copy_stop, snapshot_stop) << " ns/key";
+    std::cout << " | churn 10% " << std::setw(7) << ns_per_key(snapshot_stop, churn_stop) << " ns/key";
+    std::cout << (snapshot == copy && snapshot != set ? "" : " | contents differ") << "\n";
+}
+
+/**
+ * Measure the heap held by a set with overflowing buckets after erasing
+ * most of its keys, and after compacting it in slices of buckets.
+ *
+ * @param keys amount of keys
+ */
+void bench_expiry(std::size_t keys) {
+    const std::size_t heap_start {heap_in_use()};
+    const auto megabytes = [heap_start](std::size_t heap) {
+        return static_cast<double>(heap - heap_start) / (1024.0 * 1024.0);
+    };
+
+    ADS_set<key_type> set;
+
+    // Keys with constant low bits overflow the few buckets addressing them
+    for (std::size_t i {1}; i <= keys; ++i) {
+        set.insert(static_cast<key_type>(ADS_mix64(i) << 6));
+    }
+
+    const std::size_t heap_filled {heap_in_use()};
+
+    for (std::size_t i {1}; i <= keys; ++i) {
+        if (i % 10 != 0) set.erase(static_cast<key_type>(ADS_mix64(i) << 6));
+    }
+
+    const std::size_t heap_erased {heap_in_use()};
+    const auto compact_start {clock_type::now()};
+    std::size_t slices {1};
+    std::size_t cursor {0};
+
+    while (!set.compact_step(cursor, 4096)) ++slices;
+
+    const auto compact_stop {clock_type::now()};
+
+    std::cout << std::left << std::setw(28) << "expire 90%" << std::right << std::fixed << std::setprecision(2);
+    std::cout << " keys " << std::setw(9) << keys;
+    std::cout << " | heap " << megabytes(heap_filled) << " MiB";
+    std::cout << " | erased " << megabytes(heap_erased) << " MiB";
+    std::cout << " | compacted " << megabytes(heap_in_use()) << " MiB";
+    std::cout << " in " << slices << " slices of ";
+    std::cout << std::chrono::duration<double, std::micro>(compact_stop - compact_start).count() / static_cast<double>(slices) << " us";
+    std::cout << (set.size() == keys / 10 ? "" : " | contents differ") << "\n";
+}
+
+/**
+ * Time filling a set with keys whose low bits are constant, which grow
+ * long buckets, and looking them up. Then clear the set while it fills
+ * again, likely during a rehash, refill it and check its contents and
+ * longest bucket once more.
+ *
+ * @tparam Set set type to measure
+ * @param name name of the variant
+ * @param keys amount of keys
+ * @param shift amount of constant low bits
+ */
+template<typename Set>
+void bench_skewed(const std::string& name, std::size_t keys, unsigned shift) {
+    // Mixing keeps keys distinct within the remaining bits
+    const auto key_of = [shift](std::size_t i) {
+        return static_cast<key_type>(ADS_mix64(i) >> shift << shift);
+    };
+
+    const auto ns_per_key = [keys](clock_type::time_point start, clock_type::time_point stop) {
+        return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(keys);
+    };
+
+    const auto fill_start {clock_type::now()};
+    Set set;
+
+    for (std::size_t i {1}; i <= keys; ++i) {
+        set.insert(key_of(i));
+    }
+
+    const auto fill_stop {clock_type::now()};
+    std::size_t found {0};
+
+    for (std::size_t i {1}; i <= keys; ++i) {
+        found += set.count(key_of(i));
+    }
+
+    const auto find_stop {clock_type::now()};
+    const auto longest_bucket = [&set]() {
+        std::size_t longest {0};
+
+        for (std::size_t i {0}; i < set.bucket_count(); ++i) {
+            longest = std::max(longest, set.bucket_size(i));
+        }
+
+        return longest;
+    };
+
+    const std::size_t longest {longest_bucket()};
+
+    // Flooding again starts a rehash that clear() interrupts, the refill must be defended like the first fill
+    set.clear();
+
+    for (std::size_t i {1}; i <= keys / 2; ++i) {
+        set.insert(key_of(keys + i));
+    }
+
+    set.clear();
+
+    for (std::size_t i {1}; i <= keys; ++i) {
+        set.insert(key_of(i));
+    }
+
+    for (std::size_t i {1}; i <= keys; ++i) {
+        found += set.count(key_of(i));
+    }
+
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2);
+    std::cout << " keys " << std::setw(9) << keys;
+    std::cout << " | fill " << std::setw(7) << ns_per_key(fill_start, fill_stop) << " ns/key";
+    std::cout << " | find " << std::setw(7) << ns_per_key(fill_stop, find_stop) << " ns/key";
+    std::cout << " | buckets " << set.bucket_count() << " | longest " << longest << " | refilled " << longest_bucket();
+    std::cout << (found == 2 * keys ? "" : " | contents differ") << "\n";
+}
+
+/**
+ * Time freezing a set into a perfect hash and lookups in the frozen set.
+ */
+void bench_freeze(std::size_t keys) {
+    const auto ns_per_key = [keys](clock_type::time_point start, clock_type::time_point stop) {
+        return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(keys);
+    };
+
+    ADS_set<key_type> set;
+
+    for (std::size_t i {1}; i <= keys; ++i) {
+        set.insert(static_cast<key_type>(ADS_mix64(i)));
+    }
+
+    const auto freeze_start {clock_type::now()};
+    const auto frozen {set.freeze()};
+    const auto freeze_stop {clock_type::now()};
+    std::size_t found {0};
+
+    for (std::size_t i {1}; i <= keys; ++i) {
+        found += frozen.count(static_cast<key_type>(ADS_mix64(i)));
+    }
+
+    const auto find_stop {clock_type::now()};
+
+    std::cout << std::left << std::setw(28) << "frozen" << std::right << std::fixed << std::setprecision(2);
+    std::cout << " keys " << std::setw(9) << keys;
+    std::cout << " | freeze " << std::setw(7) << ns_per_key(freeze_start, freeze_stop) << " ns/key";
+    std::cout << " | find " << std::setw(7) << ns_per_key(freeze_stop, find_stop) << " ns/key";
+    std::cout << (found == keys ? "" : " | contents differ") << "\n";
+}
+
+void bench_paths(std::size_t keys) {
+    bench_paths<ADS_set<key_type>>("trivially copyable", keys);
+    bench_paths<ADS_set<Boxed_key, 5, Boxed_hash>>("not trivially copyable", keys);
+    bench_paths<ADS_set<key_type, 64>>("trivially copyable N=64", keys);
+    bench_paths<ADS_set<Boxed_key, 64, Boxed_hash>>("not trivially copyable N=64", keys);
+    bench_paths<ADS_set<key_type, 5, ADS_mix_hash<key_type>>>("mixed hash", keys);
+    bench_paths<ADS_set<key_type, 5, ADS_bijective_hash<key_type>>>("stored as bijective hash", keys);
+    bench_paths<ADS_set<key_type, 8>>("N=8", keys);
+    bench_paths<ADS_set<key_type, 16>>("N=16", keys);
+    bench_paths<ADS_compact_set<key_type, 0, 8>>("compact N=8", keys);
+    bench_paths<ADS_set<key_type, 5, std::hash<key_type>, Filtered_policy>>("membership filter", keys);
+    bench_freeze(keys);
+    bench_snapshot(keys);
+    bench_expiry(keys);
+    bench_skewed<ADS_set<key_type>>("skewed keys", keys, 4);
+    bench_skewed<ADS_set<key_type, 5, std::hash<key_type>, Chain_policy>>("skewed keys, chain guard", keys, 4);
+    bench_paths<ADS_set<key_type, 5, std::hash<key_type>, Reseed_policy>>("seeded hash", keys);
+    // Keys with 40 equal low bits flood the first buckets, keep that run short
+    bench_skewed<ADS_set<key_type>>("flooding keys", keys / 50, 40);
+    bench_skewed<ADS_set<key_type, 5, std::hash<key_type>, Reseed_policy>>("flooding keys, reseeding", keys / 50, 40);
+    bench_small_sets<ADS_set<key_type>>("small sets", keys, 8);
+    bench_small_sets<ADS_set<key_type, 5, std::hash<key_type>, Inline_policy>>("small sets inline", keys, 8);
+    bench_batches(keys, 10, true);
+    bench_batches(keys, 10, false);
+}
+
+/**
+ * Probe lengths of a set at one point of its growth.
+ */
+struct Probe_stats {
+    /** Average values compared by a successful lookup */
+    double hit {0};
+
+    /** Average values compared by a lookup of an absent key */
+    double miss {0};
+
+    /** Size of the longest bucket */
+    std::size_t longest {0};
+};
+
+/**
+ * Fill a set through a doubling of its keys and measure probe lengths at
+ * evenly spaced points of the doubling.
+ *
+ * @tparam Set set type to measure
+ * @param keys amount of keys at the end of the doubling
+ * @param points amount of measuring points
+ * @param lookup_ns time of looking up every key at the end, in ns per key
+ * @return probe lengths at each point
+ */
+template<typename Set>
+std::vector<Probe_stats> probe_cycle(std::size_t keys, std::size_t points, double& lookup_ns) {
+    constexpr std::size_t absent_keys {10'000};
+    std::vector<Probe_stats> stats;
+    Set set;
+    std::size_t next {1};
+
+    for (std::size_t point {0}; point <= points; ++point) {
+        const std::size_t target {keys / 2 + keys / 2 * point / points};
+
+        for (; next <= target; ++next) {
+            set.insert(static_cast<key_type>(ADS_mix64(next)));
+        }
+
+        Probe_stats stat;
+        std::size_t compared {0};
+
+        for (std::size_t i {0}; i < set.bucket_count(); ++i) {
+            const std::size_t size {set.bucket_size(i)};
+
+            compared += size * (size + 1) / 2;
+            stat.longest = std::max(stat.longest, size);
+        }
+
+        stat.hit = static_cast<double>(compared) / static_cast<double>(set.size());
+        compared = 0;
+
+        for (std::size_t i {1}; i <= absent_keys; ++i) {
+            compared += set.bucket_size(set.bucket(static_cast<key_type>(ADS_mix64(keys + i))));
+        }
+
+        stat.miss = static_cast<double>(compared) / absent_keys;
+        stats.push_back(stat);
+    }
+
+    const auto start {clock_type::now()};
+    std::size_t found {0};
+
+    for (std::size_t i {1}; i < next; ++i) {
+        found += set.count(static_cast<key_type>(ADS_mix64(i)));
+    }
+
+    lookup_ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / static_cast<double>(found);
+
+    return stats;
+}
+
+/**
+ * Compare probe lengths of one-pass splitting and partial expansions
+ * through a doubling of the keys.
+ *
+ * @param keys amount of keys at the end of the doubling
+ */
+void bench_probes(std::size_t keys) {
+    constexpr std::size_t points {16};
+    double linear_ns {0};
+    double partial_ns {0};
+    const auto linear {probe_cycle<ADS_set<key_type>>(keys, points, linear_ns)};
+    const auto partial {probe_cycle<ADS_set<key_type, 5, std::hash<key_type>, Partial_policy>>(keys, points, partial_ns)};
+    Probe_stats linear_total;
+    Probe_stats partial_total;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "     keys |  linear hit   miss longest | partial hit   miss longest\n";
+
+    for (std::size_t point {0}; point <= points; ++point) {
+        std::cout << std::setw(9) << keys / 2 + keys / 2 * point / points << " | ";
+        std::cout << std::setw(11) << linear[point].hit << std::setw(7) << linear[point].miss << std::setw(8) << linear[point].longest << " | ";
+        std::cout << std::setw(11) << partial[point].hit << std::setw(7) << partial[point].miss << std::setw(8) << partial[point].longest << "\n";
+
+        linear_total.hit += linear[point].hit / (points + 1);
+        linear_total.miss += linear[point].miss / (points + 1);
+        linear_total.longest = std::max(linear_total.longest, linear[point].longest);
+        partial_total.hit += partial[point].hit / (points + 1);
+        partial_total.miss += partial[point].miss / (points + 1);
+        partial_total.longest = std::max(partial_total.longest, partial[point].longest);
+    }
+
+    std::cout << "  average | ";
+    std::cout << std::setw(11) << linear_total.hit << std::setw(7) << linear_total.miss << std::setw(8) << linear_total.longest << " | ";
+    std::cout << std::setw(11) << partial_total.hit << std::setw(7) << partial_total.miss << std::setw(8) << partial_total.longest << "\n";
+    std::cout << "   lookup | " << std::setw(14) << linear_ns << " ns/key        | " << std::setw(14) << partial_ns << " ns/key\n";
+}
+
+/**
+ * Print the bucket occupancy of a filled set: its load, the buckets holding
+ * more values than a page and the overflow pages they need, and the
+ * longest bucket.
+ *
+ * @tparam Set set type to measure
+ * @param name name printed for the set type
+ * @param keys amount of keys to insert
+ * @param shift amount of constant low bits of the keys
+ */
+template<typename Set>
+void bench_occupancy(const std::string& name, std::size_t keys, unsigned shift = 0) {
+    Set set;
+
+    for (std::size_t i {1}; i <= keys; ++i) {
+        set.insert(static_cast<key_type>(ADS_mix64(i) >> shift << shift));
+    }
+
+    const std::size_t page {set.page_size()};
+    std::size_t overflowing {0};
+    std::size_t overflow_pages {0};
+    std::size_t longest {0};
+
+    for (std::size_t i {0}; i < set.bucket_count(); ++i) {
+        const std::size_t size {set.bucket_size(i)};
+
+        if (size > page) {
+            ++overflowing;
+            overflow_pages += (size - 1) / page;
+        }
+
+        longest = std::max(longest, size);
+    }
+
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2);
+    std::cout << " buckets " << std::setw(8) << set.bucket_count();
+    std::cout << " | load " << std::setw(5) << static_cast<double>(set.size()) / static_cast<double>(set.bucket_count() * page);
+    std::cout << " | overflowing " << std::setw(6) << 100.0 * static_cast<double>(overflowing) / static_cast<double>(set.bucket_count()) << "%";
+    std::cout << " | overflow pages " << std::setw(7) << overflow_pages;
+    std::cout << " | longest " << longest << "\n";
+}
+
+/**
+ * Compare inserting into one bucket per key with the less loaded of two,
+ * by the longest bucket, the other bucket occupancy figures and the time
+ * of each path, for evenly spread keys and keys with equal low bits.
+ *
+ * @param keys amount of keys to insert
+ */
+void bench_choices(std::size_t keys) {
+    bench_occupancy<ADS_set<key_type>>("one choice N=5", keys);
+    bench_occupancy<ADS_set<key_type, 5, std::hash<key_type>, Two_choice_policy>>("two choices N=5", keys);
+    bench_occupancy<ADS_set<key_type, 16>>("one choice N=16", keys);
+    bench_occupancy<ADS_set<key_type, 16, std::hash<key_type>, Two_choice_policy>>("two choices N=16", keys);
+    bench_paths<ADS_set<key_type>>("one choice N=5", keys);
+    bench_paths<ADS_set<key_type, 5, std::hash<key_type>, Two_choice_policy>>("two choices N=5", keys);
+    bench_paths<ADS_set<key_type, 16>>("one choice N=16", keys);
+    bench_paths<ADS_set<key_type, 16, std::hash<key_type>, Two_choice_policy>>("two choices N=16", keys);
+
+    // Keys with equal low bits share their first bucket, while their second buckets are spread by the mix
+    for (const unsigned shift: {8u, 12u}) {
+        bench_occupancy<ADS_set<key_type>>("one choice skew " + std::to_string(shift), keys, shift);
+        bench_occupancy<ADS_set<key_type, 5, std::hash<key_type>, Two_choice_policy>>("two choices skew " + std::to_string(shift), keys, shift);
+    }
+    bench_skewed<ADS_set<key_type>>("one choice skew 12", keys / 8, 12);
+    bench_skewed<ADS_set<key_type, 5, std::hash<key_type>, Two_choice_policy>>("two choices skew 12", keys / 8, 12);
+}
+
+/**
+ * Time looking up keys drawn by Zipf's law in a filled set, first with
+ * find(), then with touch(), which promotes them if the set's policy
+ * enables promote_hits.
+ *
+ * @tparam Set set type to measure
+ * @param name name printed for the set type
+ * @param keys amount of keys in the set
+ * @param lookups keys to look up, as indices of the inserted keys
+ */
+template<typename Set>
+void bench_hot_lookups(const std::string& name, std::size_t keys, const std::vector<std::size_t>& lookups) {
+    Set set;
+
+    for (std::size_t i {1}; i <= keys; ++i) {
+        set.insert(static_cast<key_type>(ADS_mix64(i)));
+    }
+
+    const auto ns_per_lookup = [&lookups](clock_type::time_point start, clock_type::time_point stop) {
+        return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(lookups.size());
+    };
+
+    const auto find_start {clock_type::now()};
+    std::size_t found {0};
+
+    for (const std::size_t index: lookups) {
+        found += set.find(static_cast<key_type>(ADS_mix64(index + 1))) != set.end();
+    }
+
+    const auto find_stop {clock_type::now()};
+
+    for (const std::size_t index: lookups) {
+        found += set.touch(static_cast<key_type>(ADS_mix64(index + 1))) != set.end();
+    }
+
+    const auto touch_stop {clock_type::now()};
+
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2);
+    std::cout << " keys " << std::setw(9) << keys;
+    std::cout << " | find " << std::setw(7) << ns_per_lookup(find_start, find_stop) << " ns/key";
+    std::cout << " | touch " << std::setw(7) << ns_per_lookup(find_stop, touch_stop) << " ns/key";
+    std::cout << (found == 2 * lookups.size() ? "" : " | keys missing") << "\n";
+}
+
+/**
+ * Compare Zipfian lookups with and without promoting hits, for bucket
+ * sizes up to disk pages.
+ *
+ * @param keys amount of keys in the set
+ */
+void bench_hot_keys(std::size_t keys) {
+    constexpr std::uint64_t seed {42};
+    std::mt19937_64 engine {seed};
+    Zipf_distribution zipf {keys, 0.99};
+    std::vector<std::size_t> ranked(keys);
+    std::vector<std::size_t> lookups(4 * keys);
+
+    // Rank keys in random order, so hot keys are not the first inserted ones at the front of their buckets
+    for (std::size_t i {0}; i < keys; ++i) ranked[i] = i;
+
+    std::shuffle(ranked.begin(), ranked.end(), engine);
+
+    for (auto& index: lookups) index = ranked[zipf(engine)];
+
+    bench_hot_lookups<ADS_set<key_type>>("N=5", keys, lookups);
+    bench_hot_lookups<ADS_set<key_type, 5, std::hash<key_type>, Promote_policy>>("N=5, promoting hits", keys, lookups);
+    bench_hot_lookups<ADS_set<Boxed_key, 64, Boxed_hash>>("boxed N=64", keys, lookups);
+    bench_hot_lookups<ADS_set<Boxed_key, 64, Boxed_hash, Promote_policy>>("boxed N=64, promoting hits", keys, lookups);
+    bench_hot_lookups<ADS_set<Boxed_key, 512, Boxed_hash>>("boxed N=512", keys, lookups);
+    bench_hot_lookups<ADS_set<Boxed_key, 512, Boxed_hash, Promote_policy>>("boxed N=512, promoting hits", keys, lookups);
+}
+
+/**
+ * Compare scanning buckets of disk page size with binary-searching sorted
+ * ones, for keys compared with vector instructions, keys stored as their
+ * hash and keys compared one by one.
+ *
+ * @param keys amount of keys to insert
+ */
+void bench_sorted(std::size_t keys) {
+    using Bijective_hash = ADS_bijective_hash<key_type>;
+
+    bench_paths<ADS_set<key_type, 64>>("N=64", keys);
+    bench_paths<ADS_set<key_type, 64, std::hash<key_type>, Sorted_policy>>("N=64, sorted", keys);
+    bench_paths<ADS_set<key_type, 512>>("N=512", keys);
+    bench_paths<ADS_set<key_type, 512, std::hash<key_type>, Sorted_policy>>("N=512, sorted", keys);
+    bench_paths<ADS_set<key_type, 512, Bijective_hash>>("bijective N=512", keys);
+    bench_paths<ADS_set<key_type, 512, Bijective_hash, Sorted_policy>>("bijective N=512, sorted", keys);
+    bench_paths<ADS_set<Boxed_key, 64, Boxed_hash>>("boxed N=64", keys);
+    bench_paths<ADS_set<Boxed_key, 64, Boxed_hash, Sorted_policy>>("boxed N=64, sorted", keys);
+    bench_paths<ADS_set<Boxed_key, 512, Boxed_hash>>("boxed N=512", keys);
+    bench_paths<ADS_set<Boxed_key, 512, Boxed_hash, Sorted_policy>>("boxed N=512, sorted", keys);
+}
+
+/**
+ * Time the paths of sets with bucket sizes chosen at runtime, next to the
+ * default bucket size fixed at compile time.
+ *
+ * @param keys amount of keys to insert
+ */
+void bench_page_sizes(std::size_t keys) {
+    bench_paths<set_type>("ADS_set N=5", keys);
+
+    for (const std::size_t page_size: {1, 2, 4, 5, 8, 16, 32, 64}) {
+        bench_paths("ADS_set runtime N=" + std::to_string(page_size), keys, ADS_set<key_type, 0>(page_size));
+    }
+}
+
+/**
+ * Measure the throughput of a string hash on keys of one length.
+ *
+ * @tparam Hasher hash function object type
+ * @param name name of the hash
+ * @param keys keys of equal length
+ * @param counters counters measuring cycles, or nullptr
+ */
+template<typename Hasher>
+void bench_string_hash(const std::string& name, const std::vector<std::string>& keys, Perf_counters* counters) {
+    constexpr std::size_t min_bytes {1u << 28};
+    const std::size_t rounds {std::max<std::size_t>(1, min_bytes / (keys.size() * keys[0].size()))};
+    const Hasher hasher {};
+    std::size_t sink {0};
+
+    if (counters) counters->start();
+
+    const auto start {clock_type::now()};
+
+    for (std::size_t round {0}; round < rounds; ++round) {
+        for (const auto& key: keys) sink += hasher(key);
+    }
+
+    const auto stop {clock_type::now()};
+
+    if (counters) counters->stop();
+
+    const double bytes {static_cast<double>(rounds * keys.size() * keys[0].size())};
+    const double ns {std::chrono::duration<double, std::nano>(stop - start).count()};
+
+    std::cout << " | " << std::left << std::setw(8) << name << std::right << std::setw(6) << bytes / ns << " GB/s ";
+
+    if (counters && counters->valid(Perf_counters::cycles)) {
+        std::cout << std::setw(5) << bytes / static_cast<double>(counters->value(Perf_counters::cycles)) << " B/cycle";
+    } else {
+        std::cout << "  n/a B/cycle";
+    }
+
+    // Keep the hashes from being optimized out
+    if (sink == 42) std::cout << " ";
+}
+
+/**
+ * Time filling a set of string keys and looking them up.
+ *
+ * @tparam Set set type to measure
+ * @param name name of the variant
+ * @param keys keys to insert
+ */
+template<typename Set>
+void bench_string_set(const std::string& name, const std::vector<std::string>& keys) {
+    const auto ns_per_key = [&keys](clock_type::time_point start, clock_type::time_point stop) {
+        return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(keys.size());
+    };
+
+    const auto fill_start {clock_type::now()};
+    Set set;
+
+    for (const auto& key: keys) set.insert(key);
+
+    const auto fill_stop {clock_type::now()};
+    std::size_t found {0};
+
+    for (const auto& key: keys) found += set.count(key);
+
+    const auto find_stop {clock_type::now()};
+
+    std::cout << std::left << std::setw(28) << name << std::right;
+    std::cout << " keys " << std::setw(9) << keys.size();
+    std::cout << " | fill " << std::setw(7) << ns_per_key(fill_start, fill_stop) << " ns/key";
+    std::cout << " | find " << std::setw(7) << ns_per_key(fill_stop, find_stop) << " ns/key";
+    std::cout << (found == keys.size() ? "" : " | contents differ") << "\n";
+}
+
+/** Hash of std::string_view by the standard library */
+using Std_string_hash = std::hash<std::string_view>;
+
+/** Portable wide-word string hash */
+struct Wide_string_hash {
+    std::size_t operator()(std::string_view key) const { return ADS_hash_bytes_wide(key.data(), key.size()); }
+};
+
+/**
+ * Compare string hashes across key lengths and in sets of URL-like keys.
+ *
+ * @param keys amount of URL-like keys
+ * @param counters counters measuring cycles, or nullptr
+ */
+void bench_strings(std::size_t keys, Perf_counters* counters) {
+    // Few enough keys per length to stay in cache, so the hash and not memory is measured
+    constexpr std::size_t sample_keys {1024};
+    std::mt19937_64 engine {42};
+    std::uniform_int_distribution<int> letter {'a', 'z'};
+
+    std::cout << std::fixed << std::setprecision(2);
+
+    for (const std::size_t length: {8, 16, 40, 64, 100, 200, 1000}) {
+        std::vector<std::string> samples(sample_keys, std::string(length, ' '));
+
+        for (auto& sample: samples) {
+            for (auto& c: sample) c = static_cast<char>(letter(engine));
+        }
+
+        std::cout << "length " << std::setw(5) << length;
+        bench_string_hash<Std_string_hash>("std", samples, counters);
+        bench_string_hash<Wide_string_hash>("wide", samples, counters);
+        bench_string_hash<ADS_string_hash>("ADS", samples, counters);
+        std::cout << "\n";
+    }
+
+    std::vector<std::string> urls;
+
+    for (std::size_t i {0}; i < keys; ++i) {
+        urls.push_back("https://example.com/catalog/items/" + std::to_string(ADS_mix64(i)) + "?ref=campaign-" + std::to_string(i % 97));
+    }
+
+    bench_string_set<ADS_set<std::string>>("URLs, std::hash", urls);
+    bench_string_set<ADS_set<std::string, 5, ADS_string_hash>>("URLs, ADS_string_hash", urls);
+}
+
+int usage() {
+    std::cerr << "usage: perftest [--perf] [run <dist> [ops] [seed] | gen <dist> <ops> <file> [seed] | replay <file> | paths [keys] | probes [keys] | pages [keys] | choices [keys] | hot [keys] | sorted [keys] | strings [keys]]\n";
+    std::cerr << "distributions: uniform, zipf, sequential, lowbit\n";
+
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    constexpr std::size_t default_ops {1'000'000};
+    constexpr std::uint64_t default_seed {42};
+    Trace trace;
+    Perf_counters* counters {nullptr};
+    Perf_counters perf;
+
+    if (!args.empty() && args[0] == "--perf") {
+        args.erase(args.begin());
+
+        if (perf.available()) counters = &perf;
+        else std::cerr << "warning: hardware performance counters are unavailable\n";
+    }
+
+    if (args.empty()) {
+        for (const auto& dist: {"uniform", "zipf", "sequential", "lowbit"}) {
+            // Low-bit keys pile up in single buckets, keep that run short
+            const std::size_t ops {std::string {dist} == "lowbit" ? default_ops / 20 : default_ops};
+
+            generate(dist, ops, default_seed, trace);
+            report(dist, trace, counters);
+        }
+
+        bench_paths(default_ops);
+
+        return 0;
+    }
+
+    if (args[0] == "strings" && args.size() <= 2) {
+        bench_strings(args.size() == 2 ? std::stoull(args[1]) : default_ops, counters);
+
+        return 0;
+    }
+
+    if (args[0] == "sorted" && args.size() <= 2) {
+        bench_sorted(args.size() == 2 ? std::stoull(args[1]) : default_ops);
+
+        return 0;
+    }
+
+    if (args[0] == "hot" && args.size() <= 2) {
+        bench_hot_keys(args.size() == 2 ? std::stoull(args[1]) : default_ops);
+
+        return 0;
+    }
+
+    if (args[0] == "choices" && args.size() <= 2) {
+        bench_choices(args.size() == 2 ? std::stoull(args[1]) : default_ops);
+
+        return 0;
+    }
+
+    if (args[0] == "pages" && args.size() <= 2) {
+        bench_page_sizes(args.size() == 2 ? std::stoull(args[1]) : default_ops);
+
+        return 0;
+    }
+
+    if (args[0] == "probes" && args.size() <= 2) {
+        bench_probes(args.size() == 2 ? std::stoull(args[1]) : default_ops);
+
+        return 0;
+    }
+
+    if (args[0] == "paths" && args.size() <= 2) {
+        bench_paths(args.size() == 2 ? std::stoull(args[1]) : default_ops);
+
+        return 0;
+    }
+
+    if (args[0] == "run" && args.size() >= 2) {
+        const std::size_t ops {args.size() >= 3 ? std::stoull(args[2]) : default_ops};
+        const std::uint64_t seed {args.size() >= 4 ? std::stoull(args[3]) : default_seed};
+
+        if (!generate(args[1], ops, seed, trace)) return usage();
+
+        report(args[1], trace, counters);
+
+        return 0;
+    }
+
+    if (args[0] == "gen" && args.size() >= 4) {
+        const std::uint64_t seed {args.size() >= 5 ? std::stoull(args[4]) : default_seed};
+
+        if (!generate(args[1], std::stoull(args[2]), seed, trace)) return usage();
+
+        if (!write_trace(args[3], trace)) {
+            std::cerr << "could not write trace " << args[3] << "\n";
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (args[0] == "replay" && args.size() == 2) {
+        if (!read_trace(args[1], trace)) {
+            std::cerr << "could not read trace " << args[1] << "\n";
+            return 1;
+        }
+
+        report(args[1], trace, counters);
+
+        return 0;
+    }
+
+    return usage();
+}